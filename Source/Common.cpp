@@ -6,8 +6,10 @@
 
 // Includes
 #include "Common.hpp"
+#include "Common\Atom.hpp"
 #include "Common\Directory.hpp"
 #include "Common\Memory.hpp"
+#include "Common\Memory\Epoch.hpp"
 #include "Common\Time.hpp"
 // -- //
 #include "Graphics.hpp"
@@ -74,7 +76,7 @@ namespace R2D
             GetCurrentDirectoryW(MAX_PATH, pathBuffer);
 
             // Translate from UTF-16 to UTF-8.
-            Directory::Working = Memory::Request<String>(narrow(std::wstring(pathBuffer)));
+            Directory::Working = Memory::Request<Path>(narrow(std::wstring(pathBuffer)));
         }
     };
 
@@ -159,6 +161,12 @@ namespace R2D
             Time::Manager::Singleton = nullptr;
         }
 
+        // Release the allocations still waiting on epoch-based reclamation.
+        Memory::Epoch::Flush();
+
+        // Release the interned strings.
+        Atom::Clear();
+
         // Release the working directory.
         Directory::Working->Release();
         Memory::Free(Directory::Working);
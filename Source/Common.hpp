@@ -31,6 +31,10 @@ namespace R2D
     // Helper function; Shorthand for casting an lvalue to an xvalue.
     template <typename Type> inline Type&& Move(Type& object) { return static_cast<Type&&>(object); };
 
+    // Helper function; Passes a forwarding reference on as it was received (an lvalue stays an lvalue, an rvalue is moved). The type has
+    // to be given explicitly, e.g. Forward<Arguments>(arguments)...
+    template <typename Type> inline Type&& Forward(Type& object) { return static_cast<Type&&>(object); };
+
     // TODO: Temporary namespace containing common debugging utilties?
     namespace Debug
     {
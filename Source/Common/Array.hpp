@@ -40,6 +40,19 @@ namespace R2D
 
         // Operators
 
+        // Move assignment operator. Releases the current entries' memory before assimilating the other array.
+        Array<Type>& operator = (Array<Type>&& other)
+        {
+            // Release the existing memory.
+            Release();
+
+            // Assimilate the other array.
+            Data = other.Data; Count = other.Count; Capacity = other.Capacity;
+            other.Data = nullptr; other.Count = 0; other.Capacity = 0;
+
+            return *this;
+        };
+
         // Array access operator.
         Type& operator [] (Int index)
         {
@@ -0,0 +1,224 @@
+/*
+-------------------------------------------------------------------------------
+    Filename: Common/Atom.cpp
+-------------------------------------------------------------------------------
+*/
+
+// Includes
+#include "..\Common\Atom.hpp"
+// -- //
+#include "..\Common\Hash.hpp"
+#include "..\Common\Memory.hpp"
+#include "..\Common\Memory\Epoch.hpp"
+// -- //
+#include <atomic>
+#include <mutex>
+
+// --------------------------------------------------------------------------------------------
+namespace R2D
+{
+    // An interned string.
+    struct AtomEntry
+    {
+        // The hash of the string.
+        uInt Hash;
+        // The interned string.
+        String Name;
+    };
+
+    // Entries are allocated in fixed-size chunks so their addresses never change once interned.
+    static constexpr Int atomChunkBits = 10;
+    static constexpr Int atomChunkSize = 1 << atomChunkBits;
+    // The chunks of entries. Published atomically so Name() can read entries without taking the lock.
+    static std::atomic<AtomEntry*> atomChunks[Atom::Limit >> atomChunkBits];
+    // The number of entries, including the reserved empty string entry at index zero.
+    static std::atomic<Int> atomCount = 1;
+
+    // Open-addressed index from string hashes to entry indices, where zero denotes an empty slot.
+    struct AtomIndex
+    {
+        // The slots of the index. A slot only ever goes from empty to holding an entry.
+        std::atomic<uInt>* Slots;
+        // The number of slots. Always a power of two.
+        Int Capacity;
+    };
+
+    // The current index. Lookups read it without locking, inside an epoch guard, and outgrown indices are retired through Memory::Epoch.
+    static std::atomic<AtomIndex*> atomIndex = nullptr;
+    // Lock held while interning new strings. Resource names are parsed on every load, and nearly all of them are interned already, so
+    // lookups don't take it.
+    static std::mutex atomMutex;
+
+    // ----------------------------------------------------------------------------------------
+    // Retrieve an entry from its index.
+    static AtomEntry& AtomLookup(uInt index)
+    {
+        return atomChunks[index >> atomChunkBits].load(std::memory_order_acquire)[index & (atomChunkSize - 1)];
+    };
+
+    // ----------------------------------------------------------------------------------------
+    // Allocate an index with every slot empty.
+    static AtomIndex* AtomCreate(Int capacity)
+    {
+        // Allocate the index and its slots in one block.
+        Byte* memory = (Byte*)Memory::Request(sizeof(AtomIndex) + sizeof(std::atomic<uInt>) * capacity, 64);
+        // -- //
+        AtomIndex* index = new(memory)AtomIndex();
+        index->Slots = (std::atomic<uInt>*)(memory + sizeof(AtomIndex));
+        index->Capacity = capacity;
+
+        // Construct the slots.
+        for(Int i = 0; i < capacity; i++) { new(index->Slots + i)std::atomic<uInt>(0); }
+        // -- //
+        return index;
+    };
+
+    // ----------------------------------------------------------------------------------------
+    // Locate the slot containing a string, or the empty slot it would be placed in. Readers must be inside an epoch guard.
+    static Int AtomProbe(const AtomIndex* index, const char* string, Int length, uInt hash)
+    {
+        Int mask = index->Capacity - 1;
+        Int slot = hash & mask;
+
+        // Linearly probe the index until either the string or an empty slot is found. Entries are stored before they're published in a
+        // slot, so any entry found here is fully constructed.
+        for(uInt entry; (entry = index->Slots[slot].load(std::memory_order_acquire)); slot = (slot + 1) & mask)
+        {
+            AtomEntry& found = AtomLookup(entry);
+            // -- //
+            if((found.Hash == hash) && (found.Name.Length() == length) && Memory::Compare(found.Name.Data(), string, length)) { break; }
+        }
+        // -- //
+        return slot;
+    };
+
+    // ----------------------------------------------------------------------------------------
+    const String& Atom::Name() const
+    {
+        static const String empty;
+        // -- //
+        return Index ? AtomLookup(Index).Name : empty;
+    };
+
+    // ----------------------------------------------------------------------------------------
+    Atom Atom::Intern(const char* string, Int length)
+    {
+        Atom atom;
+        // The empty string is never stored in the table.
+        if(length <= 0) { return atom; }
+
+        // Hash the string up front, outside of the lock.
+        atom.Hash = R2D::Hash::FNV32(string, length);
+
+        // Most strings are interned already, so first try to find the string without locking.
+        {
+            Memory::Epoch::Guard guard;
+            AtomIndex* index = atomIndex.load(std::memory_order_acquire);
+            // -- //
+            if(index) { atom.Index = index->Slots[AtomProbe(index, string, length, atom.Hash)].load(std::memory_order_acquire); }
+            if(atom.Index) { return atom; }
+        }
+
+        std::unique_lock<std::mutex> lock(atomMutex);
+
+        // Helper
+        AtomIndex* index = atomIndex.load();
+        Int count = atomCount.load(std::memory_order_relaxed);
+
+        // Grow the index to keep it at most half full. Another thread may have interned the string while this one waited for the lock,
+        // but growing early is harmless.
+        if(!index || ((count + 1) * 2 > index->Capacity))
+        {
+            Int capacity = index ? index->Capacity * 2 : 256;
+            AtomIndex* grown = AtomCreate(capacity);
+
+            // Reinsert every entry into the larger index. Nothing reads it until it's published.
+            for(Int i = 1; i < count; i++)
+            {
+                Int slot = AtomLookup(i).Hash & (capacity - 1);
+                // -- //
+                while(grown->Slots[slot].load(std::memory_order_relaxed)) { slot = (slot + 1) & (capacity - 1); }
+                grown->Slots[slot].store(i, std::memory_order_relaxed);
+            }
+
+            // Publish the new index and retire the old one once no reader can still be probing it.
+            atomIndex.store(grown, std::memory_order_release);
+            // -- //
+            if(index) { Memory::Epoch::Retire(index, [](Void* pointer) { Memory::Free(pointer); }); }
+            index = grown;
+        }
+
+        // Return the existing entry if another thread got here first.
+        Int slot = AtomProbe(index, string, length, atom.Hash);
+        // -- //
+        if(uInt existing = index->Slots[slot].load()) { atom.Index = existing; return atom; }
+
+        // Debug check
+        Assert(count < Limit, "Cannot intern the string. Too many strings have been interned.");
+
+        // Allocate a new chunk once the previous one is full.
+        Int chunk = count >> atomChunkBits;
+        // -- //
+        if(!atomChunks[chunk].load(std::memory_order_relaxed))
+        {
+            atomChunks[chunk].store((AtomEntry*)Memory::Request(sizeof(AtomEntry) * atomChunkSize), std::memory_order_release);
+        }
+
+        // Store the string and publish it in the index.
+        atom.Index = count;
+        new(&AtomLookup(atom.Index))AtomEntry{ atom.Hash, String(string, length) };
+        atomCount.store(count + 1, std::memory_order_relaxed);
+        index->Slots[slot].store(atom.Index, std::memory_order_release);
+        // -- //
+        return atom;
+    };
+
+    // ----------------------------------------------------------------------------------------
+    Atom Atom::Find(const char* string, Int length)
+    {
+        Atom atom;
+        // The empty string is never stored in the table.
+        if(length <= 0) { return atom; }
+
+        Memory::Epoch::Guard guard;
+
+        // Lookup the string.
+        uInt hash = R2D::Hash::FNV32(string, length);
+        AtomIndex* index = atomIndex.load(std::memory_order_acquire);
+        uInt entry = index ? index->Slots[AtomProbe(index, string, length, hash)].load(std::memory_order_acquire) : 0;
+        // -- //
+        if(entry) { atom.Index = entry; atom.Hash = hash; }
+        // -- //
+        return atom;
+    };
+
+    // ----------------------------------------------------------------------------------------
+    Int Atom::Count()
+    {
+        return atomCount.load();
+    };
+
+    // ----------------------------------------------------------------------------------------
+    Void Atom::Clear()
+    {
+        std::unique_lock<std::mutex> lock(atomMutex);
+
+        // Helper
+        Int count = atomCount.load();
+
+        // Destruct the entries and free their chunks.
+        for(Int i = 1; i < count; i++) { AtomLookup(i).~AtomEntry(); }
+        for(Int i = 0; i <= ((count - 1) >> atomChunkBits); i++)
+        {
+            AtomEntry* chunk = atomChunks[i].exchange(nullptr);
+            // -- //
+            if(chunk) { Memory::Free(chunk); }
+        }
+
+        // Free the index. Outgrown indices were already handed to Memory::Epoch.
+        AtomIndex* index = atomIndex.exchange(nullptr);
+        // -- //
+        if(index) { Memory::Free(index); }
+        atomCount.store(1);
+    };
+}
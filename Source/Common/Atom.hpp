@@ -0,0 +1,74 @@
+/*
+-------------------------------------------------------------------------------
+    Filename: Common/Atom.hpp
+-------------------------------------------------------------------------------
+*/
+
+// Header guard
+#pragma once
+// Includes
+#include "..\Common.hpp"
+#include "..\Common\String.hpp"
+#include "..\Common\StringView.hpp"
+
+// --------------------------------------------------------------------------------------------
+namespace R2D
+{
+    // ----------------------------------------------------------------------------------------
+    // Handle to an interned string. Every distinct string is stored once in a global table, so atoms are compared by index alone
+    // and carry the string's FNV32 hash with them. Interning is thread-safe, and only locks when the string is new. The table lives
+    // until Clear() is called at shutdown.
+    class Atom
+    {
+    public:
+        // Constants
+
+        // The maximum number of distinct strings that can be interned.
+        static constexpr Int Limit = 1 << 22;
+
+    public:
+        // Members
+
+        // Index of the string in the intern table. Zero denotes the empty string.
+        uInt Index;
+        // The FNV32 hash of the string, the same as Hash::FNV32(data, length).
+        uInt Hash;
+
+    public:
+        // Constructors
+
+        // Default constructor. The empty string.
+        constexpr Atom() : Index(0), Hash(2166136261) {};
+        // String constructor. Interns the string.
+        explicit Atom(const String& string) : Atom(Intern(string.Data(), string.Length())) {};
+        // View constructor. Interns the viewed characters, so the atom outlives the view.
+        explicit Atom(const StringView& view) : Atom(Intern(view.Data(), view.Length())) {};
+        // C-string constructor. Interns the string.
+        template <size_t size> explicit Atom(const char(&string)[size]) : Atom(Intern(string, size - 1)) {};
+        // Copy constructor.
+        constexpr Atom(const Atom& other) = default;
+
+        // Operators
+
+        // Copy assignment operator.
+        Atom& operator = (const Atom& other) = default;
+
+        // Equality operators. Atoms are equal if and only if their strings are equal.
+        Bool operator == (const Atom& other) const { return Index == other.Index; }
+        Bool operator != (const Atom& other) const { return Index != other.Index; }
+
+        // Methods
+
+        // Retrieve the interned string, e.g. for debugging. The reference stays valid until Clear() is called.
+        const String& Name() const;
+
+        // Static; Intern a string, returning the atom of the existing entry if the string was already interned.
+        static Atom Intern(const char* string, Int length);
+        // Static; Lookup a string without interning it. Returns the empty atom if the string was never interned.
+        static Atom Find(const char* string, Int length);
+        // Static; The number of strings interned so far, including the empty string.
+        static Int Count();
+        // Static; Release every interned string. Only valid once no atoms are in use anymore.
+        static Void Clear();
+    };
+}
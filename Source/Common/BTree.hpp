@@ -0,0 +1,580 @@
+/*
+-------------------------------------------------------------------------------
+    Filename: Common/BTree.hpp
+-------------------------------------------------------------------------------
+*/
+
+// Header guard
+#pragma once
+// Includes
+#include "..\Common.hpp"
+#include "..\Common\Array.hpp"
+#include "..\Common\Memory.hpp"
+// Namespace pollution (required for SSE2 intrinsics).
+#include <emmintrin.h>
+
+// --------------------------------------------------------------------------------------------
+namespace R2D
+{
+    // ----------------------------------------------------------------------------------------
+    namespace Search
+    {
+        // Count the number of keys in a sorted array that are less than (or, if inclusive, equal to) the specified key.
+        // Generic fallback for key types that only provide comparison operators.
+        template <typename Type> inline Int Rank(const Type* keys, Int count, const Type& key, Bool inclusive)
+        {
+            Int rank = 0;
+            // The keys are sorted, so the scan can stop at the first key that doesn't qualify.
+            while((rank < count) && (inclusive ? !(key < keys[rank]) : (keys[rank] < key))) { rank++; }
+            // -- //
+            return rank;
+        };
+
+        // Count the number of keys in a sorted array that are less than (or, if inclusive, equal to) the specified key.
+        // SSE2 version for signed 32-bit integer keys, comparing four keys at a time.
+        inline Int Rank(const Int* keys, Int count, const Int& key, Bool inclusive)
+        {
+            // Helpers
+            __m128i target = _mm_set1_epi32(key);
+            Int rank = 0, i = 0;
+
+            // Compare blocks of four keys until one is found containing a key past the target.
+            for(; (i + 4) <= count; i += 4)
+            {
+                __m128i block = _mm_loadu_si128((const __m128i*)(keys + i));
+                __m128i mask = _mm_cmpgt_epi32(target, block);
+                // -- //
+                if(inclusive) { mask = _mm_or_si128(mask, _mm_cmpeq_epi32(target, block)); }
+
+                // Count the qualifying keys. Since the keys are sorted, they're always the lowest lanes.
+                Int bits = _mm_movemask_ps(_mm_castsi128_ps(mask));
+                rank += POPCNT(bits);
+                // -- //
+                if(bits != 15) { return rank; }
+            }
+
+            // Compare the remaining keys one at a time.
+            for(; i < count; i++)
+            {
+                if(inclusive ? (keys[i] > key) : (keys[i] >= key)) { break; }
+                // -- //
+                rank++;
+            }
+            // -- //
+            return rank;
+        };
+
+        // Count the number of keys in a sorted array that are less than (or, if inclusive, equal to) the specified key.
+        // SSE2 version for unsigned 32-bit integer keys. Flips the sign bits so the signed comparisons order them correctly.
+        inline Int Rank(const uInt* keys, Int count, const uInt& key, Bool inclusive)
+        {
+            // Helpers
+            __m128i sign = _mm_set1_epi32(Int(0x80000000));
+            __m128i target = _mm_xor_si128(_mm_set1_epi32(Int(key)), sign);
+            Int rank = 0, i = 0;
+
+            // Compare blocks of four keys until one is found containing a key past the target.
+            for(; (i + 4) <= count; i += 4)
+            {
+                __m128i block = _mm_xor_si128(_mm_loadu_si128((const __m128i*)(keys + i)), sign);
+                __m128i mask = _mm_cmpgt_epi32(target, block);
+                // -- //
+                if(inclusive) { mask = _mm_or_si128(mask, _mm_cmpeq_epi32(target, block)); }
+
+                // Count the qualifying keys.
+                Int bits = _mm_movemask_ps(_mm_castsi128_ps(mask));
+                rank += POPCNT(bits);
+                // -- //
+                if(bits != 15) { return rank; }
+            }
+
+            // Compare the remaining keys one at a time.
+            for(; i < count; i++)
+            {
+                if(inclusive ? (keys[i] > key) : (keys[i] >= key)) { break; }
+                // -- //
+                rank++;
+            }
+            // -- //
+            return rank;
+        };
+
+        // Count the number of keys in a sorted array that are less than (or, if inclusive, equal to) the specified key.
+        // SSE2 version for 32-bit floating-point keys.
+        inline Int Rank(const Float* keys, Int count, const Float& key, Bool inclusive)
+        {
+            // Helpers
+            __m128 target = _mm_set1_ps(key);
+            Int rank = 0, i = 0;
+
+            // Compare blocks of four keys until one is found containing a key past the target.
+            for(; (i + 4) <= count; i += 4)
+            {
+                __m128 block = _mm_loadu_ps(keys + i);
+                __m128 mask = inclusive ? _mm_cmple_ps(block, target) : _mm_cmplt_ps(block, target);
+
+                // Count the qualifying keys.
+                Int bits = _mm_movemask_ps(mask);
+                rank += POPCNT(bits);
+                // -- //
+                if(bits != 15) { return rank; }
+            }
+
+            // Compare the remaining keys one at a time.
+            for(; i < count; i++)
+            {
+                if(inclusive ? (keys[i] > key) : (keys[i] >= key)) { break; }
+                // -- //
+                rank++;
+            }
+            // -- //
+            return rank;
+        };
+    }
+
+    // ----------------------------------------------------------------------------------------
+    // In-memory B+tree mapping ordered keys to values. Entries are stored in linked leaves for range iteration, and nodes
+    // are sized in whole cache lines, with the keys of every node contiguous so they can be searched with SIMD.
+    // Like Array, entries are relocated with Memory::Move and are expected to tolerate being moved bytewise.
+    // Deleting entries doesn't rebalance the tree; emptied leaves stay linked until the tree is released or rebuilt with Load().
+    template <typename Key, typename Value> class BTree
+    {
+    public:
+        // Constants
+
+        // The number of keys a node can contain. Sized so each node's keys span four cache lines.
+        static constexpr Int Order = ((256 / Int(sizeof(Key))) & ~3) < 8 ? 8 : ((256 / Int(sizeof(Key))) & ~3);
+
+        // Types
+
+        // Header shared by all of the nodes in the tree.
+        struct Node
+        {
+            // The number of keys contained in the node.
+            Int Count;
+            // The height of the node above the leaves. Leaves are level zero.
+            Int Level;
+        };
+
+        // Node containing separator keys and the children between them. Children[i] contains the keys less than Keys[i].
+        struct Inner : Node
+        {
+            // The separator keys. Each is equal to the lowest key in the subtree to its right.
+            Key Keys[Order];
+            // The child nodes. Contains one more child than there are keys.
+            Node* Children[Order + 1];
+        };
+
+        // Node containing the entries of the tree.
+        struct Leaf : Node
+        {
+            // The next leaf in key order, or nullptr if this is the last leaf.
+            Leaf* Next;
+            // The keys of the entries in the leaf.
+            Key Keys[Order];
+            // The values of the entries in the leaf.
+            Value Values[Order];
+        };
+
+        // Helper object for iterating through the entries of the tree in key order.
+        class Iterator
+        {
+        public:
+            // Members
+
+            // Handle to the leaf containing the current entry.
+            Leaf* Handle = nullptr;
+            // The index of the current entry in the leaf.
+            Int Index = 0;
+
+            // Advance the iterator to the next entry. Use Last() to determine if the entry is valid or not.
+            Void Next()
+            {
+                // Move to the next entry, skipping over any leaves emptied by deletions.
+                for(Index++; Handle && (Index >= Handle->Count); Index = 0) { Handle = Handle->Next; }
+            };
+            // Check if the iterator has reached past-the-end of the tree.
+            Bool Last() const
+            {
+                return Handle == nullptr;
+            };
+
+            // Retrieve the key of the current entry.
+            const Key& ID() const { return Handle->Keys[Index]; };
+            // Retrieve the value of the current entry.
+            Value& Data() const { return Handle->Values[Index]; };
+        };
+
+    public:
+        // Members
+
+        // The root node of the tree.
+        Node* Root;
+        // The first leaf of the tree.
+        Leaf* Head;
+        // The number of entries contained in the tree.
+        Int Count;
+
+    public:
+        // Constructors
+
+        // Default constructor.
+        BTree() : Root(nullptr), Head(nullptr), Count(0) {};
+        // Copy constructor.
+        BTree(const BTree& other) = delete;
+        // Move constructor.
+        BTree(BTree&& other) : Root(other.Root), Head(other.Head), Count(other.Count) { other.Root = nullptr; other.Head = nullptr; other.Count = 0; };
+        // Destructor.
+        ~BTree() { Release(); };
+
+        // Methods
+
+        // Destruct the entries and release the memory allocated by the tree.
+        Void Release()
+        {
+            // Free every node, starting from the root.
+            if(Root) { Free(Root); }
+            // -- //
+            Root = nullptr;
+            Head = nullptr;
+            Count = 0;
+        };
+
+        // Build the tree from an array of keys sorted in strictly ascending order, moving the values into the tree.
+        // Packs the leaves full, which suits trees that are mostly read after they're loaded.
+        Void Load(const Key* keys, Value* values, Int count)
+        {
+            // Debug check
+            Assert(!Root, "Attempting to bulk load a tree that already contains entries.");
+
+            // Nothing to do for an empty input.
+            if(count <= 0) { return; }
+
+            // The nodes of the level being built and the lowest key in each of their subtrees.
+            Array<Node*> nodes;
+            Array<Key> lowest;
+
+            // Spread the entries evenly over the fewest leaves that can contain them.
+            Int leaves = ((count - 1) / Order) + 1;
+            nodes.Reserve(leaves);
+            lowest.Reserve(leaves);
+            // -- //
+            Leaf* previous = nullptr;
+            for(Int i = 0, entry = 0; i < leaves; i++)
+            {
+                // Compute the number of entries in this leaf.
+                Int size = (count / leaves) + (i < (count % leaves) ? 1 : 0);
+                Leaf* leaf = CreateLeaf();
+
+                // Copy the keys and move the values into the leaf.
+                for(Int j = 0; j < size; j++, entry++)
+                {
+                    // Debug check
+                    Assert(!entry || (keys[entry - 1] < keys[entry]), "Cannot bulk load keys that aren't sorted in strictly ascending order.");
+
+                    new(leaf->Keys + j)Key(keys[entry]);
+                    new(leaf->Values + j)Value(R2D::Move(values[entry]));
+                }
+                leaf->Count = size;
+
+                // Link the leaf after the previous one.
+                if(previous) { previous->Next = leaf; } else { Head = leaf; }
+                previous = leaf;
+                // -- //
+                nodes.Append(leaf);
+                lowest.Append(leaf->Keys[0]);
+            }
+
+            // Build the inner levels until a single root remains.
+            for(Int level = 1; nodes.Count > 1; level++)
+            {
+                Array<Node*> parents;
+                Array<Key> parentLowest;
+
+                // Spread the children evenly over the fewest nodes that can contain them.
+                Int inners = ((nodes.Count - 1) / (Order + 1)) + 1;
+                parents.Reserve(inners);
+                parentLowest.Reserve(inners);
+                // -- //
+                for(Int i = 0, child = 0; i < inners; i++)
+                {
+                    // Compute the number of children in this node.
+                    Int size = (nodes.Count / inners) + (i < (nodes.Count % inners) ? 1 : 0);
+                    Inner* inner = CreateInner(level);
+
+                    // Link the children, using the lowest key of every child but the first as the separators.
+                    for(Int j = 0; j < size; j++, child++)
+                    {
+                        inner->Children[j] = nodes[child];
+                        // -- //
+                        if(j > 0) { new(inner->Keys + (j - 1))Key(lowest[child]); }
+                    }
+                    inner->Count = size - 1;
+                    // -- //
+                    parents.Append(inner);
+                    parentLowest.Append(lowest[child - size]);
+                }
+
+                // Move up a level.
+                nodes = R2D::Move(parents);
+                lowest = R2D::Move(parentLowest);
+            }
+
+            // The remaining node is the root.
+            Root = nodes[0];
+            Count = count;
+        };
+
+        // Construct a new entry in-place with the specified key.
+        template <typename... Arguments> Value& Add(const Key& key, Arguments&&... arguments)
+        {
+            // Allocate the root leaf if the tree is empty.
+            if(!Root) { Head = CreateLeaf(); Root = Head; }
+
+            // Descend to the leaf, remembering the path taken so splits can be propagated back up.
+            Inner* path[32];
+            Int slots[32];
+            Int depth = 0;
+            // -- //
+            Node* node = Root;
+            while(node->Level > 0)
+            {
+                Inner* inner = (Inner*)node;
+                Int slot = Search::Rank(inner->Keys, inner->Count, key, true);
+                // -- //
+                path[depth] = inner;
+                slots[depth++] = slot;
+                node = inner->Children[slot];
+            }
+
+            // Helpers
+            Leaf* leaf = (Leaf*)node;
+            Int index = Search::Rank(leaf->Keys, leaf->Count, key, false);
+
+            // Debug check
+            Assert((index == leaf->Count) || (key < leaf->Keys[index]), "Cannot add the entry. An entry with that key already exists.");
+
+            // Split the leaf if it's full and continue with whichever half the key belongs to.
+            if(leaf->Count == Order)
+            {
+                // Move the upper half of the entries into a new leaf.
+                Leaf* right = CreateLeaf();
+                Int half = Order / 2;
+                // -- //
+                Memory::Copy(right->Keys, leaf->Keys + half, sizeof(Key) * (Order - half));
+                Memory::Copy(right->Values, leaf->Values + half, sizeof(Value) * (Order - half));
+                right->Count = Order - half;
+                leaf->Count = half;
+
+                // Link the new leaf after the old one.
+                right->Next = leaf->Next;
+                leaf->Next = right;
+
+                // Insert the separator into the parents.
+                Insert(path, slots, depth, right->Keys[0], right);
+
+                // Select the half that the new entry belongs in.
+                if(index > half) { leaf = right; index -= half; }
+            }
+
+            // Shift the larger entries over and construct the new entry.
+            Memory::Move(leaf->Keys + (index + 1), leaf->Keys + index, sizeof(Key) * (leaf->Count - index));
+            Memory::Move(leaf->Values + (index + 1), leaf->Values + index, sizeof(Value) * (leaf->Count - index));
+            // -- //
+            new(leaf->Keys + index)Key(key);
+            new(leaf->Values + index)Value(arguments...);
+            leaf->Count++;
+            Count++;
+            // -- //
+            return leaf->Values[index];
+        };
+
+        // Remove an entry from the tree. Returns false if no entry with the key was found.
+        Bool Delete(const Key& key)
+        {
+            // Locate the entry.
+            Iterator iterator = Lower(key);
+            // -- //
+            if(iterator.Last() || (key < iterator.ID())) { return false; }
+
+            // Helpers
+            Leaf* leaf = iterator.Handle;
+            Int index = iterator.Index;
+
+            // Destruct the entry and shift the larger entries down over it.
+            leaf->Keys[index].~Key();
+            leaf->Values[index].~Value();
+            // -- //
+            Memory::Move(leaf->Keys + index, leaf->Keys + (index + 1), sizeof(Key) * (leaf->Count - index - 1));
+            Memory::Move(leaf->Values + index, leaf->Values + (index + 1), sizeof(Value) * (leaf->Count - index - 1));
+            leaf->Count--;
+            Count--;
+            // -- //
+            return true;
+        };
+
+        // Lookup an entry and return a pointer to its payload if one is found.
+        Value* Find(const Key& key) const
+        {
+            // Locate the first entry not less than the key and check if it matches.
+            Iterator iterator = Lower(key);
+            // -- //
+            return (!iterator.Last() && !(key < iterator.ID())) ? &iterator.Data() : nullptr;
+        };
+
+        // Retrieve an iterator to the first entry in the tree.
+        Iterator First() const
+        {
+            Iterator iterator;
+            // Start before the first entry of the first leaf and advance to it, skipping empty leaves.
+            iterator.Handle = Head;
+            iterator.Index = -1;
+            iterator.Next();
+            // -- //
+            return iterator;
+        };
+
+        // Retrieve an iterator to the first entry whose key is not less than the specified key.
+        // Iterate from here until the key passes the end of the range to visit every entry in the range.
+        Iterator Lower(const Key& key) const
+        {
+            Iterator iterator;
+            // -- //
+            if(!Root) { return iterator; }
+
+            // Descend to the leaf that would contain the key.
+            Node* node = Root;
+            while(node->Level > 0)
+            {
+                Inner* inner = (Inner*)node;
+                node = inner->Children[Search::Rank(inner->Keys, inner->Count, key, true)];
+            }
+
+            // Locate the entry within the leaf, moving on to the following leaves if the key is past its last entry.
+            iterator.Handle = (Leaf*)node;
+            iterator.Index = Search::Rank(iterator.Handle->Keys, iterator.Handle->Count, key, false) - 1;
+            iterator.Next();
+            // -- //
+            return iterator;
+        };
+
+        // Retrieve an iterator to the first entry whose key is greater than the specified key.
+        Iterator Upper(const Key& key) const
+        {
+            // Start at the lower bound and skip the matching entry, if there is one.
+            Iterator iterator = Lower(key);
+            // -- //
+            if(!iterator.Last() && !(key < iterator.ID())) { iterator.Next(); }
+            // -- //
+            return iterator;
+        };
+
+    private:
+        // Internal methods
+
+        // Static; Allocate an empty leaf aligned to a cache line.
+        static Leaf* CreateLeaf()
+        {
+            Leaf* leaf = (Leaf*)Memory::Request(sizeof(Leaf), 64);
+            // -- //
+            leaf->Count = 0;
+            leaf->Level = 0;
+            leaf->Next = nullptr;
+            // -- //
+            return leaf;
+        };
+
+        // Static; Allocate an empty inner node aligned to a cache line.
+        static Inner* CreateInner(Int level)
+        {
+            Inner* inner = (Inner*)Memory::Request(sizeof(Inner), 64);
+            // -- //
+            inner->Count = 0;
+            inner->Level = level;
+            // -- //
+            return inner;
+        };
+
+        // Static; Destruct and free a node and all of the nodes beneath it.
+        static Void Free(Node* node)
+        {
+            if(node->Level > 0)
+            {
+                Inner* inner = (Inner*)node;
+                // Free the children and destruct the separators.
+                for(Int i = 0; i <= inner->Count; i++) { Free(inner->Children[i]); }
+                for(Int i = 0; i < inner->Count; i++) { inner->Keys[i].~Key(); }
+            }
+            else
+            {
+                Leaf* leaf = (Leaf*)node;
+                // Destruct the entries.
+                for(Int i = 0; i < leaf->Count; i++) { leaf->Keys[i].~Key(); leaf->Values[i].~Value(); }
+            }
+            // -- //
+            Memory::Free(node);
+        };
+
+        // Insert a separator and the node to its right into the parent at the end of the path, splitting parents as needed.
+        Void Insert(Inner** path, Int* slots, Int depth, const Key& separator, Node* right)
+        {
+            // Copy the separator since splitting nodes may overwrite the memory it's referenced from.
+            Key key = separator;
+
+            // Walk back up the path until a parent has room for the separator.
+            while(depth > 0)
+            {
+                Inner* inner = path[--depth];
+                Int slot = slots[depth];
+
+                // Split the parent if it's full.
+                if(inner->Count == Order)
+                {
+                    // The middle separator moves up and the separators after it move into a new node.
+                    Inner* sibling = CreateInner(inner->Level);
+                    Int half = Order / 2;
+                    Key middle = inner->Keys[half];
+                    // -- //
+                    Memory::Copy(sibling->Keys, inner->Keys + (half + 1), sizeof(Key) * (Order - half - 1));
+                    Memory::Copy(sibling->Children, inner->Children + (half + 1), sizeof(Node*) * (Order - half));
+                    sibling->Count = Order - half - 1;
+                    inner->Count = half;
+
+                    // Insert the separator into whichever half it belongs in.
+                    if(slot <= half) { Place(inner, slot, key, right); }
+                    else { Place(sibling, slot - (half + 1), key, right); }
+
+                    // Continue upwards with the middle separator.
+                    key = middle;
+                    right = sibling;
+                    continue;
+                }
+
+                // The parent has room.
+                Place(inner, slot, key, right);
+                return;
+            }
+
+            // The root was split, so grow the tree by a level.
+            Inner* root = CreateInner(Root->Level + 1);
+            // -- //
+            new(root->Keys)Key(key);
+            root->Children[0] = Root;
+            root->Children[1] = right;
+            root->Count = 1;
+            Root = root;
+        };
+
+        // Static; Insert a separator and its right child into an inner node that has room for them.
+        static Void Place(Inner* inner, Int slot, const Key& key, Node* right)
+        {
+            // Shift the larger separators and children over.
+            Memory::Move(inner->Keys + (slot + 1), inner->Keys + slot, sizeof(Key) * (inner->Count - slot));
+            Memory::Move(inner->Children + (slot + 2), inner->Children + (slot + 1), sizeof(Node*) * (inner->Count - slot));
+            // -- //
+            new(inner->Keys + slot)Key(key);
+            inner->Children[slot + 1] = right;
+            inner->Count++;
+        };
+    };
+}
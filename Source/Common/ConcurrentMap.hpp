@@ -0,0 +1,356 @@
+/*
+-------------------------------------------------------------------------------
+    Filename: Common/ConcurrentMap.hpp
+-------------------------------------------------------------------------------
+*/
+
+// Header guard
+#pragma once
+// Includes
+#include "..\Common.hpp"
+#include "..\Common\Hash.hpp"
+#include "..\Common\Memory.hpp"
+#include "..\Common\Memory\Epoch.hpp"
+// Namespace pollution (required for atomics and the resize lock).
+#include <atomic>
+#include <mutex>
+#include <shared_mutex>
+
+// --------------------------------------------------------------------------------------------
+namespace R2D
+{
+    // ----------------------------------------------------------------------------------------
+    // Hash map that can be read and written from multiple threads at once. Keys are hashed the same way as in Map.
+    // Lookups never lock. Insertions and deletions claim slots with atomic compare-and-swap and only wait on each other
+    // while the table is being grown. Entries are allocated individually, so their addresses stay stable across growth,
+    // and deleted entries and outgrown tables are released through Memory::Epoch once no reader can still see them.
+    // Add() and Find() take the caller's Memory::Epoch::Guard, since the entries they return are only safe to use while it's held.
+    template <typename Key, typename Value> class ConcurrentMap
+    {
+    public:
+        // Types
+
+        // An entry in the map.
+        struct Node
+        {
+            // The cached hash of the entry's key.
+            uInt Hash;
+            // The entry's key.
+            Key ID;
+            // The entry's payload.
+            Value Data;
+
+            // Constructor; Initialize the key and construct the payload in-place.
+            template <typename... Arguments> Node(uInt hash, const Key& key, Arguments&&... arguments) : Hash(hash), ID(key), Data(arguments...) {};
+        };
+
+        // Open-addressed array of entries. Slots are claimed atomically and never reused, so a slot only ever goes from empty to
+        // holding a node, and from holding a node to holding the tombstone.
+        struct Table
+        {
+            // Array of slots referencing the entries in the table.
+            std::atomic<Node*>* Slots;
+            // The number of slots in the table. Always a power of two.
+            Int Capacity;
+        };
+
+        // Helper object for iterating through the entries in the map. Only valid while no other thread is modifying the map.
+        class Iterator
+        {
+        public:
+            // Members
+
+            // Handle to the table being iterated.
+            const Table* Handle = nullptr;
+            // The current slot of the iterator.
+            Int Index = -1;
+            // The entry at the current slot.
+            Node* Entry = nullptr;
+
+            // Advance the iterator to the next entry in the map. Use Last() to determine if the entry is valid or not.
+            Void Next()
+            {
+                // Scan forward until a slot containing an entry is found.
+                for(Index++, Entry = nullptr; Handle && (Index < Handle->Capacity); Index++)
+                {
+                    Node* node = Handle->Slots[Index].load(std::memory_order_acquire);
+                    // -- //
+                    if(node && (node != Tombstone())) { Entry = node; return; }
+                }
+            };
+            // Check if the iterator has reached past-the-end of the map.
+            Bool Last() const
+            {
+                return Entry == nullptr;
+            };
+        };
+
+    public:
+        // Members
+
+        // The table currently containing the entries of the map.
+        std::atomic<Table*> Current;
+        // The number of entries contained in the map.
+        std::atomic<Int> Count;
+        // The number of slots claimed in the current table, including deleted entries.
+        std::atomic<Int> Used;
+        // Lock shared by insertions and deletions, and held exclusively while the table is being grown.
+        std::shared_mutex Lock;
+
+    public:
+        // Constructors
+
+        // Default constructor.
+        ConcurrentMap() : Current(nullptr), Count(0), Used(0), Lock() {};
+        // Copy constructor.
+        ConcurrentMap(const ConcurrentMap& other) = delete;
+        // Move constructor.
+        ConcurrentMap(ConcurrentMap&& other) = delete;
+        // Destructor.
+        ~ConcurrentMap() { Release(); };
+
+        // Methods
+
+        // Allocate the map with the specified capacity, which must be a power of two. Not thread-safe.
+        Void Expand(Int capacity)
+        {
+            // Debug checks
+            Assert(!Current.load(), "Attempting to allocate a concurrent map that has already been allocated.");
+            Assert(POPCNT(capacity) == 1, "Cannot create maps whose capacities aren't a power of 2.");
+
+            // Create the table.
+            Current.store(Create(capacity));
+        };
+
+        // Release the entries and the memory allocated by the map. Not thread-safe.
+        Void Release()
+        {
+            Table* table = Current.exchange(nullptr);
+            // -- //
+            if(table)
+            {
+                // Destruct every entry still in the table.
+                for(Int i = 0; i < table->Capacity; i++)
+                {
+                    Node* node = table->Slots[i].load();
+                    // -- //
+                    if(node && (node != Tombstone())) { Destroy(node); }
+                }
+                // -- //
+                Memory::Free(table);
+            }
+            // -- //
+            Count.store(0);
+            Used.store(0);
+        };
+
+        // Retrieve an iterator that already contains the first entry in the map (if the map has entries).
+        Iterator First() const
+        {
+            Iterator iterator;
+            // Start the iterator before the first slot and advance it to the first entry.
+            iterator.Handle = Current.load(std::memory_order_acquire);
+            iterator.Next();
+            // -- //
+            return iterator;
+        };
+
+        // Construct a new entry in-place with the specified key, or return the existing entry if one with the key was added first.
+        // The caller's guard keeps the returned reference valid even if another thread deletes the entry, until the guard is left. It isn't
+        // read, and only serves to show at compile-time that the caller is inside a critical section.
+        template <typename... Arguments> Value& Add(const Memory::Epoch::Guard&, const Key& key, Arguments&&... arguments)
+        {
+            // Allocate the map if it hasn't been yet.
+            if(!Current.load(std::memory_order_acquire))
+            {
+                std::unique_lock<std::shared_mutex> lock(Lock);
+                // -- //
+                if(!Current.load()) { Current.store(Create(64)); }
+            }
+
+            // Hash the key and prepare the new entry up front, since it has to be fully constructed before it's published.
+            uInt hash = Hash::FNV32(key);
+            Node* entry = Memory::Request<Node>(hash, key, arguments...);
+
+            while(true)
+            {
+                {
+                    std::shared_lock<std::shared_mutex> lock(Lock);
+
+                    // Helper
+                    Table* table = Current.load(std::memory_order_acquire);
+
+                    // Keep the table at most three quarters full so probe sequences stay short.
+                    if((Used.load(std::memory_order_relaxed) + 1) * 4 <= table->Capacity * 3)
+                    {
+                        Int mask = table->Capacity - 1;
+                        Int slot = hash & mask;
+
+                        // Linearly probe the table for either an empty slot or an entry with a matching key.
+                        for(Int i = 0; i < table->Capacity; i++, slot = (slot + 1) & mask)
+                        {
+                            Node* node = table->Slots[slot].load(std::memory_order_acquire);
+
+                            // Attempt to claim the slot if it's empty.
+                            if(!node)
+                            {
+                                if(table->Slots[slot].compare_exchange_strong(node, entry, std::memory_order_acq_rel))
+                                {
+                                    // The entry was published.
+                                    Count.fetch_add(1, std::memory_order_relaxed);
+                                    Used.fetch_add(1, std::memory_order_relaxed);
+                                    // -- //
+                                    return entry->Data;
+                                }
+                                // Otherwise another thread claimed the slot first, and node now contains its entry.
+                            }
+
+                            // If another thread already added an entry with the same key, discard the new entry and return the existing one.
+                            if((node != Tombstone()) && (node->Hash == hash) && (node->ID == key))
+                            {
+                                Destroy(entry);
+                                return node->Data;
+                            }
+                        }
+                    }
+                }
+
+                // The table is too full, grow it and try again.
+                Grow();
+            }
+        };
+
+        // Remove an entry from the map. Returns false if no entry with the key was found.
+        // The entry is destructed once no other thread can still be reading it.
+        Bool Delete(const Key& key)
+        {
+            Memory::Epoch::Guard guard;
+            std::shared_lock<std::shared_mutex> lock(Lock);
+
+            // Locate the entry's slot.
+            Table* table = Current.load(std::memory_order_acquire);
+            std::atomic<Node*>* slot = Locate(table, key);
+
+            // Do nothing if the key isn't in the map.
+            if(!slot) { return false; }
+
+            Node* node = slot->load(std::memory_order_acquire);
+            // Replace the entry with a tombstone. Only one of several concurrent deletes of the same key can succeed.
+            if((node == Tombstone()) || !slot->compare_exchange_strong(node, Tombstone(), std::memory_order_acq_rel)) { return false; }
+
+            // Hand the entry off to be destroyed later.
+            Count.fetch_sub(1, std::memory_order_relaxed);
+            Memory::Epoch::Retire(node, [](Void* pointer) { Destroy((Node*)pointer); });
+            // -- //
+            return true;
+        };
+
+        // Lookup an entry and return a pointer to its payload if one is found. Never blocks.
+        // The caller's guard keeps the pointer valid even if another thread deletes the entry, so it must not be used after the guard is left.
+        // Like with Add(), the guard is only required as proof of the critical section, not read.
+        Value* Find(const Memory::Epoch::Guard&, const Key& key) const
+        {
+            // Return if the map isn't allocated yet.
+            Table* table = Current.load(std::memory_order_acquire);
+            // -- //
+            if(!table) { return nullptr; }
+
+            // Locate the entry.
+            std::atomic<Node*>* slot = Locate(table, key);
+            Node* node = slot ? slot->load(std::memory_order_acquire) : nullptr;
+            // -- //
+            return (node && (node != Tombstone())) ? &node->Data : nullptr;
+        };
+
+    private:
+        // Internal methods
+
+        // Static; Sentinel stored in the slots of deleted entries.
+        static Node* Tombstone()
+        {
+            static Byte sentinel;
+            return (Node*)&sentinel;
+        };
+
+        // Static; Allocate a table with every slot empty.
+        static Table* Create(Int capacity)
+        {
+            // Allocate the table and its slots in one block.
+            Byte* memory = (Byte*)Memory::Request(sizeof(Table) + sizeof(std::atomic<Node*>) * capacity, 64);
+            // -- //
+            Table* table = new(memory)Table();
+            table->Slots = (std::atomic<Node*>*)(memory + sizeof(Table));
+            table->Capacity = capacity;
+
+            // Construct the slots.
+            for(Int i = 0; i < capacity; i++) { new(table->Slots + i)std::atomic<Node*>(nullptr); }
+            // -- //
+            return table;
+        };
+
+        // Static; Destruct and free an entry.
+        static Void Destroy(Node* node)
+        {
+            node->~Node();
+            Memory::Free(node);
+        };
+
+        // Static; Locate the slot containing the entry with a matching key. Returns nullptr if no entry was found.
+        static std::atomic<Node*>* Locate(Table* table, const Key& key)
+        {
+            uInt hash = Hash::FNV32(key);
+            Int mask = table->Capacity - 1;
+            Int slot = hash & mask;
+
+            // Linearly probe the table until an empty slot is reached.
+            for(Int i = 0; i < table->Capacity; i++, slot = (slot + 1) & mask)
+            {
+                Node* node = table->Slots[slot].load(std::memory_order_acquire);
+
+                // An empty slot ends the probe sequence, since slots are never emptied once claimed.
+                if(!node) { break; }
+
+                // Tombstones are skipped but don't end the sequence.
+                if((node != Tombstone()) && (node->Hash == hash) && (node->ID == key)) { return table->Slots + slot; }
+            }
+            // -- //
+            return nullptr;
+        };
+
+        // Replace the current table with a larger one, dropping the tombstones. Readers keep using the old table until the new one is published.
+        Void Grow()
+        {
+            std::unique_lock<std::shared_mutex> lock(Lock);
+
+            // Helper
+            Table* table = Current.load();
+
+            // Another thread may have already grown the table while this one was waiting for the lock.
+            if((Used.load() + 1) * 4 <= table->Capacity * 3) { return; }
+
+            // Double the capacity, unless the table is mostly tombstones and simply needs to be cleaned.
+            Int capacity = (Count.load() * 2 > table->Capacity) ? table->Capacity * 2 : table->Capacity;
+            Table* grown = Create(capacity);
+
+            // Move the entries over to the new table. No other writers can be running at this point.
+            for(Int i = 0; i < table->Capacity; i++)
+            {
+                Node* node = table->Slots[i].load();
+                // -- //
+                if(!node || (node == Tombstone())) { continue; }
+
+                Int slot = node->Hash & (capacity - 1);
+                // Linearly probe for an empty slot.
+                while(grown->Slots[slot].load()) { slot = (slot + 1) & (capacity - 1); }
+                // -- //
+                grown->Slots[slot].store(node, std::memory_order_relaxed);
+            }
+
+            // Publish the new table and retire the old one once no reader can still be probing it.
+            Current.store(grown, std::memory_order_release);
+            Used.store(Count.load());
+            // -- //
+            Memory::Epoch::Retire(table, [](Void* pointer) { Memory::Free(pointer); });
+        };
+    };
+}
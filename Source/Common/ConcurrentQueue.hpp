@@ -0,0 +1,169 @@
+/*
+-------------------------------------------------------------------------------
+    Filename: Common/ConcurrentQueue.hpp
+-------------------------------------------------------------------------------
+*/
+
+// Header guard
+#pragma once
+// Includes
+#include "..\Common.hpp"
+#include "..\Common\Memory.hpp"
+// Namespace pollution (required for atomics).
+#include <atomic>
+
+// --------------------------------------------------------------------------------------------
+namespace R2D
+{
+    // ----------------------------------------------------------------------------------------
+    // Bounded first-in first-out queue that any number of threads can push to and pop from at once without locks.
+    // Every slot carries a sequence number telling which lap of the ring it's ready for and whether it's waiting to be written or read,
+    // so producers and consumers only contend on the position counter they claim slots from, and never wait on each other
+    // unless the queue is full or empty. Use RingQueue instead when there's a single producer and a single consumer.
+    template <typename Type> class ConcurrentQueue
+    {
+    public:
+        // Constants
+
+        // The size of a cache line. Members written by different threads are kept this far apart to avoid false sharing.
+        static constexpr Int CacheLine = 64;
+
+        // Types
+
+        // A slot in the ring.
+        struct Slot
+        {
+            // The slot is ready to be written at position Sequence, and to be read at position Sequence - 1.
+            std::atomic<Long> Sequence;
+            // Storage for the object.
+            alignas(Type) Byte Storage[sizeof(Type)];
+        };
+
+    public:
+        // Members
+
+        // The position of the next slot to pop from. Claimed by consumers.
+        alignas(CacheLine) std::atomic<Long> Head;
+        // The position of the next slot to push to. Claimed by producers.
+        alignas(CacheLine) std::atomic<Long> Tail;
+
+        // The slots of the ring.
+        alignas(CacheLine) Slot* Slots;
+        // The number of slots in the ring. Always a power of two.
+        Int Capacity;
+
+    public:
+        // Constructors
+
+        // Default constructor.
+        ConcurrentQueue() : Head(0), Tail(0), Slots(nullptr), Capacity(0) {};
+        // Copy constructor.
+        ConcurrentQueue(const ConcurrentQueue& other) = delete;
+        // Move constructor.
+        ConcurrentQueue(ConcurrentQueue&& other) = delete;
+        // Destructor.
+        ~ConcurrentQueue() { Release(); };
+
+        // Methods
+
+        // Allocate the queue with the specified capacity, which must be a power of two. Not thread-safe.
+        Void Expand(Int capacity)
+        {
+            // Debug checks
+            Assert(!Slots, "Attempting to allocate a queue that has already been allocated.");
+            Assert(POPCNT(capacity) == 1, "Cannot create queues whose capacities aren't a power of 2.");
+
+            // Allocate the slots, each ready to be written during the first lap.
+            Slots = (Slot*)Memory::Request(sizeof(Slot) * capacity, (alignof(Slot) > 16) ? alignof(Slot) : 16);
+            Capacity = capacity;
+            // -- //
+            for(Int i = 0; i < capacity; i++) { new(&Slots[i].Sequence)std::atomic<Long>(i); }
+        };
+
+        // Destruct the remaining objects and release the slots. Not thread-safe.
+        Void Release()
+        {
+            // Destruct every object still in the queue.
+            for(Long i = Head.load(); i < Tail.load(); i++) { ((Type*)Slots[i & (Capacity - 1)].Storage)->~Type(); }
+
+            // Release the slots and reset the positions.
+            if(Slots) { Memory::Free(Slots); Slots = nullptr; }
+            Capacity = 0;
+            Head.store(0);
+            Tail.store(0);
+        };
+
+        // Construct an object at the end of the queue. Returns false if the queue is full.
+        template <typename... Arguments> Bool Push(Arguments&&... arguments)
+        {
+            // Helpers
+            Long position = Tail.load(std::memory_order_relaxed);
+            Slot* slot;
+
+            // Claim the slot at the tail position.
+            while(true)
+            {
+                slot = &Slots[position & (Capacity - 1)];
+                Long difference = slot->Sequence.load(std::memory_order_acquire) - position;
+
+                // The slot is free for this lap; Try to claim it by advancing the tail (which reloads position if another producer won).
+                if(difference == 0)
+                {
+                    if(Tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) { break; }
+                }
+                // The slot still holds an object from the previous lap, the queue is full.
+                else if(difference < 0) { return false; }
+                // Another producer already claimed the slot, catch up with the tail.
+                else { position = Tail.load(std::memory_order_relaxed); }
+            }
+
+            // Construct the object and mark the slot as ready to be read.
+            new(slot->Storage)Type(Forward<Arguments>(arguments)...);
+            slot->Sequence.store(position + 1, std::memory_order_release);
+            // -- //
+            return true;
+        };
+
+        // Move the object at the front of the queue into the output and remove it. Returns false if the queue is empty.
+        Bool Pop(Type& output)
+        {
+            // Helpers
+            Long position = Head.load(std::memory_order_relaxed);
+            Slot* slot;
+
+            // Claim the slot at the head position.
+            while(true)
+            {
+                slot = &Slots[position & (Capacity - 1)];
+                Long difference = slot->Sequence.load(std::memory_order_acquire) - (position + 1);
+
+                // The slot holds an object for this lap; Try to claim it by advancing the head (which reloads position if another consumer won).
+                if(difference == 0)
+                {
+                    if(Head.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) { break; }
+                }
+                // The slot hasn't been written yet, the queue is empty.
+                else if(difference < 0) { return false; }
+                // Another consumer already claimed the slot, catch up with the head.
+                else { position = Head.load(std::memory_order_relaxed); }
+            }
+
+            // Move the object out, destruct it and mark the slot as ready to be written during the next lap.
+            Type* object = (Type*)slot->Storage;
+            output = R2D::Move(*object);
+            object->~Type();
+            slot->Sequence.store(position + Capacity, std::memory_order_release);
+            // -- //
+            return true;
+        };
+
+        // The number of objects in the queue. Only a snapshot if other threads are active.
+        Int Count() const
+        {
+            // Read the head first, so the tail read after it can't be behind it.
+            Long head = Head.load(std::memory_order_acquire);
+            // -- //
+            return Int(Tail.load(std::memory_order_acquire) - head);
+        };
+    };
+}
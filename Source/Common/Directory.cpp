@@ -7,43 +7,50 @@
 // Includes
 #include "..\Common\Directory.hpp"
 // -- //
+#include <atomic>
+#include <thread>
+#if defined(_WIN32)
 #include "..\Common\Windows.hpp"
+#else
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#if defined(__linux__)
+#include <sys/syscall.h>
+#endif
+#endif
 
 // --------------------------------------------------------------------------------------------
 namespace R2D
 {
     // ----------------------------------------------------------------------------------------
-    String* Directory::Working = nullptr;
+    Path* Directory::Working = nullptr;
 
     // ----------------------------------------------------------------------------------------
-    Void Directory::Read(const String& directory)
+    Void Directory::Read(const StringView& directory)
     {
-        std::wstring wdirectory;
-        // Prepare a UTF-16 path for WINAPI.
-        {
-            // Search for a colon symbol (that usually follows a drive symbol..) to determine if the path is absolute.
-            Int pos = directory.Find(':');
+        // Resolve the path; Relative paths are joined onto the working directory.
+        Path path;
+        // -- //
+        if(Directory::Working) { path = *Directory::Working; }
+        path.Join(directory);
 
-            // If the symbol wasn't found..
-            if(pos == directory.Length)
-            {
-                // Prefix the working directory to the local path and convert the string to UTF-16.
-                wdirectory = widen(*Directory::Working + "\\" + directory + "*");
-            }
-            else
-            {
-                // Simply convert the absolute path to UTF-16.
-                wdirectory = widen(directory + "*");
-            }
-        }
+        #if defined(_WIN32)
+        // Append the wildcard to search for every object in the directory and convert the pattern to UTF-16 for WINAPI.
+        path.Join("*");
+        std::wstring wdirectory = widen(path);
 
         WIN32_FIND_DATA ffd;
         // Find the first object in the directory.
         HANDLE hFind = FindFirstFileW(wdirectory.c_str(), &ffd);
 
         // Debug check
-        Assert(hFind != INVALID_HANDLE_VALUE, "No such directory was found.");
-        // TODO: This is ideally a warning but no method for handling warnings exists yet.
+        Warning(hFind != INVALID_HANDLE_VALUE, "No such directory was found.");
+        // -- //
+        if(hFind == INVALID_HANDLE_VALUE) { return; }
 
         // Continue locating and adding objects to the directory.
         do
@@ -52,19 +59,19 @@ namespace R2D
             String name = narrow(ffd.cFileName);
 
             // Check if the last character of the filename isn't a period (to skip the "." and ".." directory operators).
-            if(name[name.Length - 1] != '.')
+            if(name[name.Length() - 1] != '.')
             {
                 // If the result is a directory..
                 if(ffd.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)
                 {
                     // Append to the folders array.
-                    Folders.Reserve(1);
+                    if(Folders.Count == Folders.Capacity) { Folders.Reserve(Folders.Capacity ? Folders.Capacity : 16); }
                     Folders.Append(Move(name));
                 }
                 else
                 {
                     // Append to the files array.
-                    Files.Reserve(1);
+                    if(Files.Count == Files.Capacity) { Files.Reserve(Files.Capacity ? Files.Capacity : 16); }
                     Files.Append(Move(name));
                 }
             }
@@ -72,5 +79,414 @@ namespace R2D
 
         // Release the search handle.
         FindClose(hFind);
+        #else
+        // Open the directory stream.
+        DIR* stream = opendir(path.Data());
+
+        // Debug check
+        Warning(stream, "No such directory was found.");
+        // -- //
+        if(!stream) { return; }
+
+        // Remember the length and hash of the directory's path, so each entry's path can be joined onto it when it has to be inspected.
+        Int length = path.Length();
+        uInt digest = path.Hash();
+
+        // Continue locating and adding objects to the directory.
+        while(dirent* entry = readdir(stream))
+        {
+            // Helper
+            StringView name(entry->d_name, Int(strlen(entry->d_name)));
+
+            // Skip the "." and ".." directory operators.
+            if((name == ".") || (name == "..")) { continue; }
+
+            // Most filesystems report the type of the object in the entry, otherwise the object has to be inspected.
+            Bool folder = (entry->d_type == DT_DIR);
+            // -- //
+            if(entry->d_type == DT_UNKNOWN)
+            {
+                struct stat info;
+                path.Join(name);
+                folder = (stat(path.Data(), &info) == 0) && S_ISDIR(info.st_mode);
+                path.Truncate(length, digest);
+            }
+
+            // If the result is a directory..
+            if(folder)
+            {
+                // Append to the folders array.
+                if(Folders.Count == Folders.Capacity) { Folders.Reserve(Folders.Capacity ? Folders.Capacity : 16); }
+                Folders.Append(String(name));
+            }
+            else
+            {
+                // Append to the files array.
+                if(Files.Count == Files.Capacity) { Files.Reserve(Files.Capacity ? Files.Capacity : 16); }
+                Files.Append(String(name));
+            }
+        }
+
+        // Release the directory stream.
+        closedir(stream);
+        #endif
     }
+
+    #if defined(_WIN32)
+    // ----------------------------------------------------------------------------------------
+    // A folder being scanned; Its full path in UTF-16.
+    struct DirectoryCursor
+    {
+        std::wstring Path;
+    };
+    #else
+    // ----------------------------------------------------------------------------------------
+    // A folder being scanned; A descriptor of the open folder, which its contents are opened and inspected relative to.
+    struct DirectoryCursor
+    {
+        int Descriptor;
+    };
+
+    #if defined(__linux__)
+    // ----------------------------------------------------------------------------------------
+    // The layout of the records returned by getdents64.
+    struct DirectoryRecord
+    {
+        uLong Inode;
+        Long Next;
+        unsigned short Length;
+        uByte Type;
+        Byte Name[1];
+    };
+    #endif
+    #endif
+
+    // ----------------------------------------------------------------------------------------
+    // Add an object to a listing. Its path is the parent's path joined with its name.
+    static Void DirectoryAdd(Directory::Listing& listing, Int parent, const StringView& name, Directory::Kind type, Long size, Long modified)
+    {
+        // Helpers
+        Int prefix = (parent >= 0) ? listing.Entries[parent].Length + 1 : 0;
+        Int length = prefix + name.Length();
+
+        // Grow the text and the entries geometrically. The text holds a terminator after each path.
+        if(listing.Text.Count + length + 1 > listing.Text.Capacity)
+        {
+            Int grow = (listing.Text.Capacity > length + 1) ? listing.Text.Capacity : (length + 1) * 64;
+            listing.Text.Reserve(grow);
+        }
+        if(listing.Entries.Count == listing.Entries.Capacity) { listing.Entries.Reserve(listing.Entries.Capacity ? listing.Entries.Capacity : 64); }
+
+        // Write the path.
+        Byte* text = listing.Text.Data + listing.Text.Count;
+        if(parent >= 0)
+        {
+            Memory::Copy(text, listing.Text.Data + listing.Entries[parent].Offset, prefix - 1);
+            text[prefix - 1] = '/';
+        }
+        Memory::Copy(text + prefix, name.Data(), name.Length());
+        text[length] = 0;
+
+        // Add the entry.
+        Directory::Entry entry = { listing.Text.Count, length, parent, type, size, modified };
+        listing.Entries.Append(entry);
+        listing.Text.Count += length + 1;
+    };
+
+    // ----------------------------------------------------------------------------------------
+    // Add the contents of a folder (but not its subfolders' contents) to a listing.
+    static Void DirectoryList(Directory::Listing& listing, DirectoryCursor& cursor, Int parent)
+    {
+        #if defined(_WIN32)
+        // Search for every object in the folder. The basic information level skips the short names, and large fetches
+        // return more objects per call.
+        WIN32_FIND_DATAW data;
+        HANDLE find = FindFirstFileExW((cursor.Path + L"\\*").c_str(), FindExInfoBasic, &data, FindExSearchNameMatch, nullptr, FIND_FIRST_EX_LARGE_FETCH);
+        // -- //
+        if(find == INVALID_HANDLE_VALUE) { return; }
+
+        do
+        {
+            // Skip the "." and ".." directory operators.
+            if((data.cFileName[0] == L'.') && (!data.cFileName[1] || ((data.cFileName[1] == L'.') && !data.cFileName[2]))) { continue; }
+
+            // Translate the name from UTF-16 to UTF-8.
+            Byte name[MAX_PATH * 3];
+            int length = WideCharToMultiByte(CP_UTF8, 0, data.cFileName, -1, name, sizeof(name), nullptr, nullptr) - 1;
+
+            // Debug check
+            Assert(length > 0, "There was a problem converting the string.");
+
+            // The search returns the type, size and modification time of each object along with its name.
+            Directory::Kind type = (data.dwFileAttributes & FILE_ATTRIBUTE_REPARSE_POINT) ? Directory::Kind::Link :
+                ((data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) ? Directory::Kind::Folder : Directory::Kind::File);
+            Long size = (Long(data.nFileSizeHigh) << 32) | data.nFileSizeLow;
+            // File times count 100 nanosecond intervals since 1601.
+            Long modified = ((Long(data.ftLastWriteTime.dwHighDateTime) << 32) | data.ftLastWriteTime.dwLowDateTime) - 116444736000000000ll;
+            // -- //
+            DirectoryAdd(listing, parent, StringView(name, length), type, (type == Directory::Kind::Folder) ? 0 : size, modified * 100);
+        } while(FindNextFileW(find, &data));
+
+        // Release the search handle.
+        FindClose(find);
+        #else
+        // Add an object, inspecting it relative to the folder.
+        auto add = [&](const Byte* name, uByte hint)
+        {
+            // Skip the "." and ".." directory operators.
+            if((name[0] == '.') && (!name[1] || ((name[1] == '.') && !name[2]))) { return; }
+
+            // Inspect the object without following links, falling back on the type reported by the folder.
+            Directory::Kind type = (hint == DT_DIR) ? Directory::Kind::Folder : ((hint == DT_LNK) ? Directory::Kind::Link : Directory::Kind::File);
+            Long size = 0, modified = 0;
+            // -- //
+            struct stat info;
+            if(fstatat(cursor.Descriptor, name, &info, AT_SYMLINK_NOFOLLOW) == 0)
+            {
+                type = S_ISDIR(info.st_mode) ? Directory::Kind::Folder : (S_ISLNK(info.st_mode) ? Directory::Kind::Link : Directory::Kind::File);
+                size = S_ISDIR(info.st_mode) ? 0 : Long(info.st_size);
+                #if defined(__APPLE__)
+                modified = Long(info.st_mtimespec.tv_sec) * 1000000000ll + info.st_mtimespec.tv_nsec;
+                #else
+                modified = Long(info.st_mtim.tv_sec) * 1000000000ll + info.st_mtim.tv_nsec;
+                #endif
+            }
+
+            DirectoryAdd(listing, parent, StringView(name, Int(strlen(name))), type, size, modified);
+        };
+
+        #if defined(__linux__)
+        // Read the folder's records straight from the kernel, many per call.
+        alignas(8) Byte buffer[32768];
+        while(true)
+        {
+            long bytes = syscall(SYS_getdents64, cursor.Descriptor, buffer, sizeof(buffer));
+            // -- //
+            if(bytes <= 0) { break; }
+
+            for(long offset = 0; offset < bytes;)
+            {
+                DirectoryRecord* record = (DirectoryRecord*)(buffer + offset);
+                offset += record->Length;
+                // -- //
+                add(record->Name, record->Type);
+            }
+        }
+        #else
+        // Read the folder through a duplicate descriptor, which the stream takes ownership of.
+        DIR* stream = fdopendir(dup(cursor.Descriptor));
+        // -- //
+        if(!stream) { return; }
+        while(dirent* entry = readdir(stream)) { add(entry->d_name, entry->d_type); }
+        closedir(stream);
+        #endif
+        #endif
+    };
+
+    // ----------------------------------------------------------------------------------------
+    // Open a subfolder of a folder being scanned.
+    static Bool DirectoryEnter(const DirectoryCursor& cursor, DirectoryCursor& child, const StringView& name)
+    {
+        #if defined(_WIN32)
+        child.Path = cursor.Path + L"\\" + widen(name);
+        return true;
+        #else
+        // The name is null-terminated in the listing's text.
+        child.Descriptor = openat(cursor.Descriptor, name.Data(), O_RDONLY | O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC);
+        return child.Descriptor >= 0;
+        #endif
+    };
+
+    // ----------------------------------------------------------------------------------------
+    // Close a folder being scanned.
+    static Void DirectoryLeave(DirectoryCursor& cursor)
+    {
+        #if !defined(_WIN32)
+        close(cursor.Descriptor);
+        #endif
+    };
+
+    // ----------------------------------------------------------------------------------------
+    // Add the contents of a folder and all its subfolders to a listing.
+    static Void DirectoryWalk(Directory::Listing& listing, DirectoryCursor& cursor, Int parent)
+    {
+        // List the folder's own contents first, so they stay contiguous.
+        Int first = listing.Entries.Count;
+        DirectoryList(listing, cursor, parent);
+        Int last = listing.Entries.Count;
+
+        // Then descend into each subfolder.
+        for(Int i = first; i < last; i++)
+        {
+            // -- //
+            if(listing.Entries[i].Type != Directory::Kind::Folder) { continue; }
+
+            DirectoryCursor child;
+            if(DirectoryEnter(cursor, child, listing.Name(i)))
+            {
+                DirectoryWalk(listing, child, i);
+                DirectoryLeave(child);
+            }
+        }
+    };
+
+    // ----------------------------------------------------------------------------------------
+    Void Directory::Scan(const StringView& directory, Listing& listing, Int threads)
+    {
+        // Resolve the path; Relative paths are joined onto the working directory.
+        Path path;
+        // -- //
+        if(Directory::Working) { path = *Directory::Working; }
+        path.Join(directory);
+
+        // Start from an empty listing.
+        listing.Entries.Count = 0;
+        listing.Text.Count = 0;
+
+        // Open the directory.
+        DirectoryCursor root;
+        #if defined(_WIN32)
+        root.Path = widen(path);
+        #else
+        root.Descriptor = open(path.Data(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+
+        // Debug check
+        Assert(root.Descriptor >= 0, "No such directory was found.");
+        // -- //
+        if(root.Descriptor < 0) { return; }
+        #endif
+
+        // List the directory's own contents, and find its subfolders.
+        DirectoryList(listing, root, -1);
+        // -- //
+        Int count = listing.Entries.Count;
+        Int folders = 0;
+        for(Int i = 0; i < count; i++) { folders += (listing.Entries[i].Type == Kind::Folder); }
+
+        // Helper
+        if(threads <= 0) { threads = Int(std::thread::hardware_concurrency()); }
+        if(threads > folders) { threads = folders; }
+
+        // Scan the subfolders one after another on this thread.
+        if(threads <= 1)
+        {
+            for(Int i = 0; i < count; i++)
+            {
+                // -- //
+                if(listing.Entries[i].Type != Kind::Folder) { continue; }
+
+                DirectoryCursor child;
+                if(DirectoryEnter(root, child, listing.Name(i)))
+                {
+                    DirectoryWalk(listing, child, i);
+                    DirectoryLeave(child);
+                }
+            }
+        }
+        // Or scan each subfolder into a listing of its own on a pool of threads, then append those listings in order.
+        else
+        {
+            // Each partial listing starts with a copy of its subfolder's entry, which its contents are added under.
+            Listing* parts = (Listing*)Memory::Request(sizeof(Listing) * count);
+            for(Int i = 0; i < count; i++) { new(parts + i)Listing(); }
+
+            // The threads take the subfolders in turn.
+            std::atomic<Int> next(0);
+            auto work = [&]()
+            {
+                for(Int i = next++; i < count; i = next++)
+                {
+                    // -- //
+                    if(listing.Entries[i].Type != Kind::Folder) { continue; }
+
+                    DirectoryCursor child;
+                    if(DirectoryEnter(root, child, listing.Name(i)))
+                    {
+                        const Entry& folder = listing.Entries[i];
+                        DirectoryAdd(parts[i], -1, listing.Path(i), folder.Type, folder.Size, folder.Modified);
+                        DirectoryWalk(parts[i], child, 0);
+                        DirectoryLeave(child);
+                    }
+                }
+            };
+
+            // Run the work on the helper threads and the calling thread.
+            std::thread* helpers = (std::thread*)Memory::Request(sizeof(std::thread) * (threads - 1));
+            for(Int i = 1; i < threads; i++) { new(helpers + (i - 1))std::thread(work); }
+            // -- //
+            work();
+            for(Int i = 1; i < threads; i++) { helpers[i - 1].join(); helpers[i - 1].~thread(); }
+            Memory::Free(helpers);
+
+            // Append the partial listings, skipping their copies of the subfolder entries.
+            for(Int i = 0; i < count; i++)
+            {
+                Listing& part = parts[i];
+                // -- //
+                if(part.Entries.Count > 1)
+                {
+                    // Helpers
+                    Int skipped = part.Entries[0].Length + 1;
+                    Int entries = part.Entries.Count - 1;
+                    Int text = part.Text.Count - skipped;
+                    Int base = listing.Entries.Count;
+                    Int offset = listing.Text.Count - skipped;
+
+                    // Make room for the part.
+                    if(listing.Entries.Count + entries > listing.Entries.Capacity) { listing.Entries.Reserve(entries); }
+                    if(listing.Text.Count + text > listing.Text.Capacity) { listing.Text.Reserve(text); }
+
+                    // Copy the paths, and the entries with their offsets and parents moved to the merged listing.
+                    Memory::Copy(listing.Text.Data + listing.Text.Count, part.Text.Data + skipped, text);
+                    listing.Text.Count += text;
+                    // -- //
+                    for(Int j = 1; j <= entries; j++)
+                    {
+                        Entry entry = part.Entries[j];
+                        entry.Offset += offset;
+                        entry.Parent = entry.Parent ? base + entry.Parent - 1 : i;
+                        listing.Entries.Append(entry);
+                    }
+                }
+                part.~Listing();
+            }
+            Memory::Free(parts);
+        }
+
+        // Close the directory.
+        DirectoryLeave(root);
+    };
+
+    // ----------------------------------------------------------------------------------------
+    Bool Directory::Create(const StringView& directory)
+    {
+        // Resolve the path; Relative paths are joined onto the working directory.
+        Path path;
+        // -- //
+        if(Directory::Working) { path = *Directory::Working; }
+        path.Join(directory);
+
+        // Helper
+        Int root = path.Root();
+        Bool created = true;
+
+        // Create each folder along the path in turn, from the outermost one; Folders that already exist are skipped over.
+        for(Int end = root; end <= path.Length(); end++)
+        {
+            // -- //
+            if(end < path.Length() && path.Data()[end] != Path::Separator) { continue; }
+            if(end == root) { continue; }
+
+            #if defined(_WIN32)
+            std::wstring wpath = widen(StringView(path.Data(), end));
+            created = CreateDirectoryW(wpath.c_str(), nullptr) || GetLastError() == ERROR_ALREADY_EXISTS;
+            #else
+            String part(path.Data(), end);
+            created = !mkdir(part.Data(), 0755) || errno == EEXIST;
+            #endif
+        }
+
+        // Only the result of the innermost folder matters; Creating the outer ones may fail for folders that can't be written to.
+        return created;
+    };
 }
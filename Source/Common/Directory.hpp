@@ -9,7 +9,9 @@
 // Includes
 #include "..\Common.hpp"
 #include "..\Common\Array.hpp"
+#include "..\Common\Path.hpp"
 #include "..\Common\String.hpp"
+#include "..\Common\StringView.hpp"
 
 // --------------------------------------------------------------------------------------------
 namespace R2D
@@ -17,6 +19,82 @@ namespace R2D
     // ----------------------------------------------------------------------------------------
     class Directory
     {
+    public:
+        // Types
+
+        // The kinds of objects found in a directory.
+        enum class Kind : Byte
+        {
+            File = 0, // A regular file (or any other object that isn't a folder or a link).
+            Folder = 1, // A folder. Scanned recursively.
+            Link = 2 // A symbolic link or other reparse point. Not followed, so scans can't loop.
+        };
+
+        // An object found while scanning a directory tree.
+        struct Entry
+        {
+            // The offset of the object's path in the listing's text.
+            Int Offset;
+            // The length of the object's path.
+            Int Length;
+            // The index of the entry of the folder containing the object, or -1 if it's directly in the scanned directory.
+            Int Parent;
+            // The kind of object.
+            Kind Type;
+            // The size of the object in bytes. Zero for folders.
+            Long Size;
+            // The time the object was last modified, in nanoseconds since 1970-01-01 UTC.
+            Long Modified;
+        };
+
+        // ------------------------------------------------------------------------------------
+        // Flat listing of a directory tree, produced by Scan(). The entries of each folder are contiguous and come before the entries
+        // of its subfolders. Paths are relative to the scanned directory, use '/' separators and are stored back-to-back in a single
+        // block of text (each one null-terminated), so a listing makes two allocations however many objects it holds.
+        class Listing
+        {
+        public:
+            // Members
+
+            // The objects in the tree.
+            Array<Entry> Entries;
+            // The paths of the objects.
+            Array<Byte> Text;
+
+        public:
+            // Constructors
+
+            // Default constructor.
+            Listing() : Entries(), Text() {};
+            // Copy constructor.
+            Listing(const Listing& other) = delete;
+            // Move constructor.
+            Listing(Listing&& other) : Entries(Move(other.Entries)), Text(Move(other.Text)) {};
+            // Destructor.
+            ~Listing() { Release(); };
+
+            // Methods
+
+            // The path of an entry, relative to the scanned directory.
+            StringView Path(Int index) const
+            {
+                return StringView(Text.Data + Entries.Data[index].Offset, Entries.Data[index].Length);
+            };
+            // The name of an entry, which is the last part of its path.
+            StringView Name(Int index) const
+            {
+                // Helper
+                const Entry& entry = Entries.Data[index];
+                // The name starts after the parent's path and a separator.
+                Int start = (entry.Parent >= 0) ? Entries.Data[entry.Parent].Length + 1 : 0;
+                // -- //
+                return StringView(Text.Data + entry.Offset + start, entry.Length - start);
+            };
+
+            // Release the entries and their paths.
+            Void Release() { Entries.Release(); Text.Release(); };
+        };
+
     public:
         // Members
 
@@ -25,8 +103,8 @@ namespace R2D
         // Array containing the names of the files located in this directory.
         Array<String> Files;
 
-        // Static; The current working directory of the executable.
-        static String* Working;
+        // Static; The current working directory of the executable. Relative paths are resolved against it.
+        static Path* Working;
 
     public:
         // Constructors
@@ -42,7 +120,14 @@ namespace R2D
 
         // Methods
 
-        // Populate the directory object with the names of a path's contents.
-        Void Read(const String& path);
+        // Populate the directory object with the names of a path's contents. Either Windows or POSIX separators may be used.
+        Void Read(const StringView& path);
+
+        // Static; Scan a directory and all its subfolders into a listing, along with each object's size and modification time.
+        // The subfolders of the directory are scanned on up to the specified number of threads (zero uses one per hardware thread);
+        // The listing is the same however many are used.
+        static Void Scan(const StringView& path, Listing& listing, Int threads = 1);
+        // Static; Create a folder, along with any of its parents that don't exist yet. Returns false if the folder couldn't be created.
+        static Bool Create(const StringView& path);
     };
 }
@@ -7,19 +7,40 @@
 // Includes
 #include "..\Common\File.hpp"
 // -- //
+#include "..\Common\Array.hpp"
 #include "..\Common\Directory.hpp"
+#include "..\Common\FileQueue.hpp"
+#include "..\Common\Path.hpp"
+#include "..\Common\Sort.hpp"
 // -- //
+#include <thread>
+// -- //
+#if defined(_WIN32)
 #include "..\Common\Windows.hpp"
+#else
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 // ----------------------------------------------------------------------------------------
 namespace R2D
 {
     // ------------------------------------------------------------------------------------
-    Void File::Open(const String& filename, File::Mode filemode)
+    Void File::Open(const StringView& filename, File::Mode filemode)
     {
         // Debug check
         Assert(!Handle, "Attempting to open a file that is already open.");
 
+        // Resolve the path; Relative paths are joined onto the working directory.
+        Path path;
+        // -- //
+        if(Directory::Working) { path = *Directory::Working; }
+        path.Join(filename);
+
+        #if defined(_WIN32)
         // Prepare to set file the creation policies.
         DWORD fileAccessPolicy = 0, fileCreationPolicy = 0;
         {
@@ -38,27 +59,8 @@ namespace R2D
             }
         }
 
-        // Prepare the file path.
-        std::wstring path;
-        {
-            // Search for a colon symbol (that usually follows a drive symbol..) to determine if the path is absolute.
-            Int pos = filename.Find(':');
-
-            // If the symbol wasn't found..
-            if(pos == filename.Length)
-            {
-                // Prefix the working directory to the local path and convert the string to UTF-16.
-                path = widen(*Directory::Working + "\\" + filename);
-            }
-            else
-            {
-                // Simply convert the absolute path to UTF-16.
-                path = widen(filename);
-            }
-        }
-
-        // Open the file.
-        Handle = CreateFileW(path.c_str(), fileAccessPolicy, FILE_SHARE_READ, nullptr, fileCreationPolicy, FILE_ATTRIBUTE_NORMAL, nullptr);
+        // Open the file, converting the path to UTF-16.
+        Handle = CreateFileW(widen(path).c_str(), fileAccessPolicy, FILE_SHARE_READ, nullptr, fileCreationPolicy, FILE_ATTRIBUTE_NORMAL, nullptr);
 
         // Debug checks
         Assert(Handle, "There was a problem opening a file.");
@@ -73,56 +75,366 @@ namespace R2D
 
         // Set file size.
         Size = Long(fileInfo.nFileSizeLow) | (Long(fileInfo.nFileSizeHigh) << 32);
+        #else
+        // Prepare the access and creation flags, mirroring the Windows creation policies.
+        int flags = 0;
+        {
+            // Helpers
+            Bool reading = bool(filemode & File::Mode::Read);
+            Bool writing = bool(filemode & File::Mode::Write) || bool(filemode & File::Mode::Overwrite);
+
+            // Pick the access mode.
+            flags = (reading && writing) ? O_RDWR : (writing ? O_WRONLY : O_RDONLY);
+
+            // Writing creates the file if it doesn't exist, and overwriting empties it.
+            if(writing) { flags |= O_CREAT; }
+            if(bool(filemode & File::Mode::Overwrite)) { flags |= O_TRUNC; }
+        }
 
-        // Initialize the position index.
-        Seek(0, Offset::Current);
+        // Open the file. The descriptor is stored offset by one, so that a null handle still means the file is closed.
+        int descriptor = open(path.Data(), flags | O_CLOEXEC, 0644);
+
+        // Debug check
+        Assert(descriptor >= 0, "There was a problem opening a file.");
+        // -- //
+        Handle = (Void*)(intptr_t(descriptor) + 1);
+
+        // Retrieve the file information description.
+        struct stat fileInfo;
+        int result = fstat(descriptor, &fileInfo);
+
+        // Debug check
+        Assert(result == 0, "There was a problem retrieving the properties of a file.");
+
+        // Set file size.
+        Size = Long(fileInfo.st_size);
+        #endif
+
+        // Initialize the position index; Write access starts at the end of the file.
+        Seek(0, bool(filemode & File::Mode::Write) ? Offset::End : Offset::Begin);
     };
 
+    #if !defined(_WIN32)
+    // ------------------------------------------------------------------------------------
+    // Recover the file descriptor stored in a file handle.
+    static inline int FileDescriptor(Void* handle)
+    {
+        return int(intptr_t(handle) - 1);
+    };
+    #endif
+
     // ------------------------------------------------------------------------------------
     Void File::Close()
     {
         // Release the file.
+        #if defined(_WIN32)
         if(Handle) { CloseHandle(Handle); Handle = nullptr; }
+        #else
+        if(Handle) { close(FileDescriptor(Handle)); Handle = nullptr; }
+        #endif
+    };
+
+    // ------------------------------------------------------------------------------------
+    Bool File::Exists(const StringView& filename)
+    {
+        // Resolve the path; Relative paths are joined onto the working directory.
+        Path path;
+        // -- //
+        if(Directory::Working) { path = *Directory::Working; }
+        path.Join(filename);
+
+        // Query the object's attributes without opening it.
+        #if defined(_WIN32)
+        DWORD attributes = GetFileAttributesW(widen(path).c_str());
+        // -- //
+        return (attributes != INVALID_FILE_ATTRIBUTES) && !(attributes & FILE_ATTRIBUTE_DIRECTORY);
+        #else
+        struct stat status;
+        // -- //
+        return (stat(path.Data(), &status) == 0) && S_ISREG(status.st_mode);
+        #endif
+    };
+
+    // ------------------------------------------------------------------------------------
+    Bool File::Delete(const StringView& filename)
+    {
+        // Resolve the path; Relative paths are joined onto the working directory.
+        Path path;
+        // -- //
+        if(Directory::Working) { path = *Directory::Working; }
+        path.Join(filename);
+
+        // Remove the file's directory entry.
+        #if defined(_WIN32)
+        return DeleteFileW(widen(path).c_str()) != 0;
+        #else
+        return unlink(path.Data()) == 0;
+        #endif
+    };
+
+    // ------------------------------------------------------------------------------------
+    // Open a range of the files requested from ReadMany(), recording their inodes as sort keys, and start reading them ahead.
+    static Void FileOpenMany(const File::Request* requests, File* files, Sort::Key64* keys, Int begin, Int end)
+    {
+        // A single path is reused for each file; Relative paths are joined onto the working directory and truncated off again.
+        Path path;
+        // -- //
+        if(Directory::Working) { path = *Directory::Working; }
+        Int length = path.Length();
+        uInt digest = path.Hash();
+        Bool replaced = false;
+
+        // Open the files.
+        for(Int i = begin; i < end; i++)
+        {
+            // Files that can't be opened sort first, and are skipped.
+            keys[i].Key = 0;
+            keys[i].Index = uInt(i);
+
+            // Absolute filenames replace the working directory rather than joining onto it, and ".." components can go above it, so it
+            // then has to be joined back in full.
+            if(replaced) { path.Clear(); if(Directory::Working) { path.Join(*Directory::Working); } }
+            else { path.Truncate(length, digest); }
+            // -- //
+            path.Join(requests[i].Filename);
+            replaced = !path.Keeps(length);
+
+            #if defined(_WIN32)
+            HANDLE handle = CreateFileW(widen(path).c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+            // -- //
+            if(handle == INVALID_HANDLE_VALUE) { continue; }
+
+            // Retrieve the size and the file index, the closest thing to an inode.
+            BY_HANDLE_FILE_INFORMATION fileInfo;
+            // -- //
+            if(!GetFileInformationByHandle(handle, &fileInfo)) { CloseHandle(handle); continue; }
+            files[i].Handle = handle;
+            files[i].Size = Long(fileInfo.nFileSizeLow) | (Long(fileInfo.nFileSizeHigh) << 32);
+            keys[i].Key = uLong(fileInfo.nFileIndexLow) | (uLong(fileInfo.nFileIndexHigh) << 32);
+            #else
+            int descriptor = open(path.Data(), O_RDONLY | O_CLOEXEC);
+            // -- //
+            if(descriptor < 0) { continue; }
+
+            // Retrieve the size and the inode.
+            struct stat fileInfo;
+            // -- //
+            if((fstat(descriptor, &fileInfo) != 0) || !S_ISREG(fileInfo.st_mode)) { close(descriptor); continue; }
+            files[i].Handle = (Void*)(intptr_t(descriptor) + 1);
+            files[i].Size = Long(fileInfo.st_size);
+            keys[i].Key = uLong(fileInfo.st_ino);
+
+            // Start reading the whole file in the background, so the reads that follow find it cached.
+            posix_fadvise(descriptor, 0, 0, POSIX_FADV_WILLNEED);
+            #endif
+        }
+    };
+
+    // ------------------------------------------------------------------------------------
+    Void File::ReadMany(Request* requests, Int count)
+    {
+        // -- //
+        if(count <= 0) { return; }
+
+        // Prepare the files, and the keys to sort them by.
+        File* files = (File*)Memory::Request(sizeof(File) * count);
+        for(Int i = 0; i < count; i++) { new(files + i)File(); }
+        // -- //
+        Array<Sort::Key64> order;
+        order.Reserve(count);
+        order.Count = count;
+
+        // Open the files in parallel, since opening is mostly waiting on path lookups; Small batches aren't worth a thread.
+        Int threads = Int(std::thread::hardware_concurrency());
+        if(threads > count / 64) { threads = count / 64; }
+        // -- //
+        if(threads < 2) { FileOpenMany(requests, files, order.Data, 0, count); }
+        else
+        {
+            // Helper
+            Int step = (count + threads - 1) / threads;
+
+            // The calling thread opens the first range.
+            std::thread* workers = (std::thread*)Memory::Request(sizeof(std::thread) * (threads - 1));
+            for(Int i = 1; i < threads; i++)
+            {
+                // Helpers
+                Int begin = (i * step < count) ? i * step : count;
+                Int end = (begin + step < count) ? begin + step : count;
+                // -- //
+                new(workers + i - 1)std::thread(FileOpenMany, requests, files, order.Data, begin, end);
+            }
+            // -- //
+            FileOpenMany(requests, files, order.Data, 0, step);
+            for(Int i = 0; i < threads - 1; i++) { workers[i].join(); workers[i].~thread(); }
+            Memory::Free(workers);
+        }
+
+        // Allocate the missing buffers. Empty files don't get one.
+        for(Int i = 0; i < count; i++)
+        {
+            // -- //
+            requests[i].Result = files[i].Handle ? 0 : -1;
+            if(!files[i].Handle || requests[i].Destination) { continue; }
+
+            // -- //
+            requests[i].Size = files[i].Size;
+            if(files[i].Size) { requests[i].Destination = Memory::Request(files[i].Size); }
+        }
+
+        // Read the files through a queue, submitting them in the order of their inodes, which file systems tend to allocate in the order
+        // of the files' data. Several reads are in flight at once, so files still waiting on the disk don't hold up the ones whose
+        // read-ahead has already arrived.
+        Sort::Radix(order);
+        // -- //
+        Int depth = (count < 64) ? count : 64;
+        Int workers = Int(std::thread::hardware_concurrency());
+        FileQueue queue;
+        queue.Expand(depth, (workers < depth) ? workers : depth);
+        FileQueue::Request* reads = (FileQueue::Request*)Memory::Request(sizeof(FileQueue::Request) * count);
+        // -- //
+        for(Int i = 0; i < count; i++)
+        {
+            // Helper
+            uInt index = order[i].Index;
+            // -- //
+            if(!files[index].Handle || !files[index].Size) { continue; }
+
+            FileQueue::Request& read = reads[index];
+            read.Source = &files[index];
+            read.Offset = 0;
+            read.Size = (requests[index].Size < files[index].Size) ? requests[index].Size : files[index].Size;
+            read.Destination = requests[index].Destination;
+            read.Callback = nullptr;
+            read.Context = nullptr;
+            // -- //
+            while(!queue.Submit(read)) { queue.Wait(); }
+        }
+        // -- //
+        queue.Finish();
+        for(Int i = 0; i < count; i++) { if(files[i].Handle && files[i].Size) { requests[i].Result = reads[i].Result; } }
+        queue.Release();
+
+        // Close the files.
+        for(Int i = 0; i < count; i++) { files[i].~File(); }
+        // -- //
+        Memory::Free(reads);
+        Memory::Free(files);
+        order.Release();
     };
 
     // ------------------------------------------------------------------------------------
     Long File::Seek(Long seek, Offset offset)
     {
-        // Update the file pointer and position value.
-        Position = SetFilePointer(Handle, seek, nullptr, (DWORD)offset);
+        // Update the position value. The operating system's file pointer isn't used, since every read and write is positional.
+        switch(offset)
+        {
+            case Offset::Begin: { Position = seek; break; };
+            case Offset::Current: { Position += seek; break; };
+            case Offset::End: { Position = Size + seek; break; };
+        }
         return Position;
     };
 
     // ------------------------------------------------------------------------------------
-    template <> Void File::Read(Void* buffer, Long size)
+    Long File::ReadAt(Long offset, Void* buffer, Long size) const
     {
-        // Prepare to receive the number of bytes read.
-        DWORD bytesRead;
+        // Read the data, continuing after partial reads until the end of the file.
+        Long bytesRead = 0;
+        while(bytesRead < size)
+        {
+            #if defined(_WIN32)
+            // Passing the offset through an OVERLAPPED structure reads from it regardless of the handle's file pointer.
+            OVERLAPPED overlapped = {};
+            overlapped.Offset = DWORD(offset + bytesRead);
+            overlapped.OffsetHigh = DWORD((offset + bytesRead) >> 32);
+            // -- //
+            DWORD chunk = DWORD(((size - bytesRead) < (1 << 30)) ? (size - bytesRead) : (1 << 30));
+            DWORD result = 0;
 
-        // Read the data.
-        BOOL result = ReadFile(Handle, buffer, size, &bytesRead, nullptr);
+            // Reading at or past the end of the file fails with ERROR_HANDLE_EOF, which just means there's nothing left.
+            BOOL success = ReadFile(Handle, (Byte*)buffer + bytesRead, chunk, &result, &overlapped);
+
+            // Debug check
+            Assert(success || (GetLastError() == ERROR_HANDLE_EOF), "There was a problem reading data from a file.");
+            #else
+            ssize_t result = pread(FileDescriptor(Handle), (Byte*)buffer + bytesRead, size_t(size - bytesRead), off_t(offset + bytesRead));
+
+            // Retry reads interrupted by a signal.
+            if((result < 0) && (errno == EINTR)) { continue; }
+
+            // Debug check
+            Assert(result >= 0, "There was a problem reading data from a file.");
+            #endif
+
+            // -- //
+            if(Long(result) <= 0) { break; }
+            bytesRead += Long(result);
+        }
+        return bytesRead;
+    };
+
+    // ------------------------------------------------------------------------------------
+    Long File::WriteAt(Long offset, const Void* buffer, Long size)
+    {
+        // Write the data, continuing after partial writes.
+        Long bytesWritten = 0;
+        while(bytesWritten < size)
+        {
+            #if defined(_WIN32)
+            // Passing the offset through an OVERLAPPED structure writes at it regardless of the handle's file pointer.
+            OVERLAPPED overlapped = {};
+            overlapped.Offset = DWORD(offset + bytesWritten);
+            overlapped.OffsetHigh = DWORD((offset + bytesWritten) >> 32);
+            // -- //
+            DWORD chunk = DWORD(((size - bytesWritten) < (1 << 30)) ? (size - bytesWritten) : (1 << 30));
+            DWORD result = 0;
+            BOOL success = WriteFile(Handle, (const Byte*)buffer + bytesWritten, chunk, &result, &overlapped);
+
+            // Debug check
+            Warning(success, "There was a problem writing data to a file.");
+            // -- //
+            if(!success) { break; }
+            #else
+            ssize_t result = pwrite(FileDescriptor(Handle), (const Byte*)buffer + bytesWritten, size_t(size - bytesWritten), off_t(offset + bytesWritten));
+
+            // Retry writes interrupted by a signal.
+            if((result < 0) && (errno == EINTR)) { continue; }
+
+            // Debug check
+            Warning(result >= 0, "There was a problem writing data to a file.");
+            #endif
+
+            // -- //
+            if(Long(result) <= 0) { break; }
+            bytesWritten += Long(result);
+        }
+
+        // Increase Size if the file is having new bytes written to the end of it.
+        if((offset + bytesWritten) > Size) { Size = offset + bytesWritten; }
+
+        return bytesWritten;
+    };
+
+    // ------------------------------------------------------------------------------------
+    template <> Void File::Read(Void* buffer, Long size)
+    {
+        // Read the data at the file pointer.
+        Long bytesRead = ReadAt(Position, buffer, size);
         Position += bytesRead;
 
-        // Debug checks
-        Assert(result > 0, "There was a problem reading data from a file.");
+        // Debug check
         Assert(size == bytesRead, "Attempted to read past the end file.");
     };
 
     // ------------------------------------------------------------------------------------
     template <> Void File::Write(const Void* buffer, Long size)
     {
-        // Prepare to receive the number of bytes written.
-        DWORD bytesWritten;
-
-        // Write the data.
-        BOOL result = WriteFile(Handle, buffer, size, &bytesWritten, nullptr);
+        // Write the data at the file pointer.
+        Long bytesWritten = WriteAt(Position, buffer, size);
         Position += bytesWritten;
 
-        // Increase Size if the file is having new bytes written to the end of it.
-        if(Position > Size) { Size = Position; }
-
-        // Debug checks
-        Assert(result > 0, "There was a problem writing data to a file.");
+        // Debug check
         Assert(size == bytesWritten, "The file had less bytes written to it than requested.");
     };
 
@@ -140,4 +452,104 @@ namespace R2D
 
         return buffer;
     };
+
+    // ------------------------------------------------------------------------------------
+    File::View File::Map(Mapping mapping, Long offset, Long size)
+    {
+        // Debug checks
+        Assert(Handle, "Attempting to map a file that isn't open.");
+        Assert((offset >= 0) && (size >= 0) && ((offset + size) <= Size), "Attempting to map a range outside of the file.");
+
+        View view;
+        // Empty ranges can't be mapped, and don't need to be.
+        if(!size) { return view; }
+
+        #if defined(_WIN32)
+        // Views have to start on a multiple of the allocation granularity, so map from the boundary before the offset.
+        SYSTEM_INFO system;
+        GetSystemInfo(&system);
+        // -- //
+        Long start = offset - (offset % Long(system.dwAllocationGranularity));
+
+        // Create a mapping object for the file. The view keeps the mapping alive, so the object can be closed straight away.
+        HANDLE object = CreateFileMappingW(Handle, nullptr, (mapping == Mapping::Copy) ? PAGE_WRITECOPY : PAGE_READONLY, 0, 0, nullptr);
+
+        // Debug check
+        Assert(object, "There was a problem creating a mapping of a file.");
+
+        // Map the view.
+        view.Base = MapViewOfFile(object, (mapping == Mapping::Copy) ? FILE_MAP_COPY : FILE_MAP_READ, DWORD(start >> 32), DWORD(start), SIZE_T(offset + size - start));
+        CloseHandle(object);
+
+        // Debug check
+        Assert(view.Base, "There was a problem mapping a view of a file.");
+        #else
+        // Views have to start on a page boundary, so map from the boundary before the offset.
+        Long start = offset - (offset % Long(sysconf(_SC_PAGESIZE)));
+
+        // Map the view. Read-only views are shared so they use the file cache's pages, and copy-on-write views are private.
+        Void* base = mmap(nullptr, size_t(offset + size - start), PROT_READ | ((mapping == Mapping::Copy) ? PROT_WRITE : 0),
+            (mapping == Mapping::Copy) ? MAP_PRIVATE : MAP_SHARED, FileDescriptor(Handle), off_t(start));
+
+        // Debug check
+        Assert(base != MAP_FAILED, "There was a problem mapping a view of a file.");
+        // -- //
+        view.Base = (base != MAP_FAILED) ? base : nullptr;
+        #endif
+
+        // Point the view at the requested range.
+        if(view.Base)
+        {
+            view.Data = (Byte*)view.Base + (offset - start);
+            view.Size = size;
+            view.Length = offset + size - start;
+        }
+
+        return view;
+    };
+
+    // ------------------------------------------------------------------------------------
+    Void File::View::Advise(Access access)
+    {
+        // -- //
+        if(!Base) { return; }
+
+        #if defined(_WIN32)
+        // Windows only takes read-ahead hints when opening the file, but the pages can be prefetched.
+        if((access == Access::Sequential) || (access == Access::Prefetch))
+        {
+            WIN32_MEMORY_RANGE_ENTRY range = { Base, SIZE_T(Length) };
+            // -- //
+            PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+        }
+        #else
+        // Translate the hint.
+        int advice = MADV_NORMAL;
+        switch(access)
+        {
+            case Access::Normal: { advice = MADV_NORMAL; break; };
+            case Access::Sequential: { advice = MADV_SEQUENTIAL; break; };
+            case Access::Random: { advice = MADV_RANDOM; break; };
+            case Access::Prefetch: { advice = MADV_WILLNEED; break; };
+        }
+        // -- //
+        madvise(Base, size_t(Length), advice);
+        #endif
+    };
+
+    // ------------------------------------------------------------------------------------
+    Void File::View::Release()
+    {
+        // Unmap the view.
+        #if defined(_WIN32)
+        if(Base) { UnmapViewOfFile(Base); }
+        #else
+        if(Base) { munmap(Base, size_t(Length)); }
+        #endif
+        // Reset the members.
+        Data = nullptr;
+        Size = 0;
+        Base = nullptr;
+        Length = 0;
+    };
 }
@@ -10,6 +10,7 @@
 #include "..\Common.hpp"
 #include "..\Common\Memory\Buffer.hpp"
 #include "..\Common\String.hpp"
+#include "..\Common\StringView.hpp"
 
 // --------------------------------------------------------------------------------------------
 namespace R2D
@@ -38,6 +39,92 @@ namespace R2D
             Current = 1, // Seek offset from the current position in the file.
             End = 2 // Seek offset from the end of the file.
         };
+        // Mapping modes; How a mapped view of a file can be accessed.
+        enum class Mapping : Byte
+        {
+            // Read-only view. The pages are shared with the operating system's file cache and with other processes mapping the file.
+            Read = 0,
+            // Copy-on-write view. The view can be written to, but pages are copied when first written and changes never reach the file.
+            Copy = 1
+        };
+        // Access pattern hints for mapped views, used by the operating system to decide how far to read ahead.
+        enum class Access : Byte
+        {
+            Normal = 0, // No particular access pattern.
+            Sequential = 1, // The view will be read in order, so pages can be read ahead aggressively.
+            Random = 2, // The view will be read in no particular order, so reading ahead is wasted.
+            Prefetch = 3 // The whole view will be needed soon, so start reading it in now.
+        };
+        // A request to read a whole file, for ReadMany().
+        struct Request
+        {
+            // The path of the file to read. Relative paths are resolved against the working directory.
+            StringView Filename;
+            // The buffer to read into. If it's a nullptr, a buffer the size of the file is allocated with Memory::Request() and
+            // stored here, and the caller frees it.
+            Void* Destination;
+            // The size of the destination buffer, or the size of the file if the buffer is allocated.
+            Long Size;
+            // The number of bytes read, which is less than Size if the file is smaller, or -1 if the file couldn't be opened.
+            Long Result;
+        };
+
+        // ------------------------------------------------------------------------------------
+        // A range of a file mapped into memory. The view stays valid after the file is closed, until it's released.
+        class View
+        {
+        public:
+            // Members
+
+            // Handle to the first byte of the mapped range.
+            Byte* Data;
+            // The size of the mapped range in bytes.
+            Long Size;
+            // The start of the mapping, which is aligned to the system's allocation granularity so it can be before Data.
+            Void* Base;
+            // The size of the mapping starting at Base, in bytes.
+            Long Length;
+
+        public:
+            // Constructors
+
+            // Default constructor.
+            View() : Data(nullptr), Size(0), Base(nullptr), Length(0) {};
+            // Copy constructor.
+            View(const View& other) = delete;
+            // Move constructor.
+            View(View&& other) : Data(other.Data), Size(other.Size), Base(other.Base), Length(other.Length)
+            {
+                other.Data = nullptr; other.Size = 0; other.Base = nullptr; other.Length = 0;
+            };
+            // Destructor.
+            ~View() { Release(); };
+
+            // Operators
+
+            // Move assignment operator. Releases the current mapping before assimilating the other view.
+            View& operator = (View&& other)
+            {
+                // Release the existing mapping.
+                Release();
+
+                // Assimilate the other view.
+                Data = other.Data; Size = other.Size; Base = other.Base; Length = other.Length;
+                other.Data = nullptr; other.Size = 0; other.Base = nullptr; other.Length = 0;
+
+                return *this;
+            };
+
+            // Methods
+
+            // Hint how the view is going to be accessed.
+            Void Advise(Access access);
+            // Unmap the view.
+            Void Release();
+
+            // Retrieve a buffer for reading the view's contents. The buffer doesn't own the data, so the view must outlive it.
+            Memory::Buffer Contents() { return Memory::Buffer(Data, Size, false); };
+        };
 
     public:
         // Members
@@ -48,6 +135,7 @@ namespace R2D
         Long Size;
         // The position of the file pointer used for the next read/write operation.
         // The end of the file is reached when this is equal to the file's size.
+        // Kept by the file object itself rather than the operating system, so positional reads and writes don't disturb it.
         Long Position;
 
     public:
@@ -64,19 +152,41 @@ namespace R2D
 
         // Methods
 
-        // Open a file.
-        Void Open(const String& filename, Mode filemode);
+        // Open a file. Relative paths are resolved against the working directory, and either Windows or POSIX separators may be used.
+        Void Open(const StringView& filename, Mode filemode);
         // Close the current handle.
         Void Close();
 
-        // Move the file read/write index. To be implemented later.
+        // Static; Check if a file exists. Folders don't count as files.
+        static Bool Exists(const StringView& filename);
+        // Static; Delete a file. Returns false if it couldn't be deleted, e.g. because it doesn't exist.
+        static Bool Delete(const StringView& filename);
+        // Static; Read many whole files at once, e.g. the shader files of a resource location. The files are opened in parallel, read-ahead
+        // is started for all of them up front, and they're read through a FileQueue in the order of their inodes (roughly their order on
+        // disk), so thousands of small files don't each pay for an open's latency and a seek.
+        static Void ReadMany(Request* requests, Int count);
+
+        // Move the file read/write index. Returns the new position.
         Long Seek(Long seek, Offset offset);
 
+        // Read bytes starting at an offset in the file, without using or moving the file pointer. Returns the number of bytes read,
+        // which is less than size if the end of the file is reached. Any number of threads can read from the same file at once.
+        Long ReadAt(Long offset, Void* buffer, Long size) const;
+        // Write bytes starting at an offset in the file, without using or moving the file pointer. Returns the number of bytes written,
+        // which is less than size if the write failed, e.g. because the disk is full.
+        Long WriteAt(Long offset, const Void* buffer, Long size);
+
         // Load and return a memory buffer containing the specified amount of data from the file.
         Memory::Buffer Load(Long size);
         // Load and return a memory buffer containing the remaining data in a file.
         Memory::Buffer Load() { return Load(Size - Position); };
 
+        // Map a range of the file into memory instead of copying it. The file must have been opened with read access.
+        // Doesn't use or move the file pointer.
+        View Map(Mapping mapping, Long offset, Long size);
+        // Map the whole file into memory.
+        View Map(Mapping mapping = Mapping::Read) { return Map(mapping, 0, Size); };
+
         // Read an object from the file. Preferably, only call this for POD types that don't contain pointers.
         template <typename Type> Type Read()
         {
@@ -109,7 +219,7 @@ namespace R2D
         template <> Void Write(const String& string)
         {
             // Call the Void specialization to write the string's data to the file.
-            Write(string.Data, string.Length);
+            Write(string.Data(), string.Length());
         };
     };
 
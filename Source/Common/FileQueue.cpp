@@ -0,0 +1,410 @@
+/*
+-------------------------------------------------------------------------------
+    Filename: Common/FileQueue.cpp
+-------------------------------------------------------------------------------
+*/
+
+// Includes
+#include "..\Common\FileQueue.hpp"
+// -- //
+#include "..\Common\ConcurrentQueue.hpp"
+#include "..\Common\Memory.hpp"
+// -- //
+#include <semaphore>
+#include <thread>
+#if defined(__linux__)
+#include <errno.h>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// --------------------------------------------------------------------------------------------
+namespace R2D
+{
+    // The longest read handed to the operating system at once. Longer requests are read in several parts.
+    static constexpr Long fileQueueChunk = 1 << 30;
+
+    // ----------------------------------------------------------------------------------------
+    // The state of a queue's backend.
+    struct FileQueueBackend
+    {
+        // Requests waiting for a thread in the pool.
+        ConcurrentQueue<FileQueue::Request*> Incoming;
+        // Requests completed by the pool, waiting to be collected.
+        ConcurrentQueue<FileQueue::Request*> Completed;
+        // The number of requests in each queue, which the threads wait on.
+        std::counting_semaphore<> IncomingCount{ 0 };
+        std::counting_semaphore<> CompletedCount{ 0 };
+        // The threads of the pool, or a nullptr if io_uring is used instead.
+        std::thread* Workers = nullptr;
+        Int WorkerCount = 0;
+        // Set to make the threads of the pool exit.
+        std::atomic<Bool> Stopping{ false };
+
+        #if defined(__linux__)
+        // The ring's file descriptor, or -1 if the pool is used instead.
+        int Ring = -1;
+        // The mappings of the submission ring, the completion ring (which can share the submission ring's mapping) and the submission entries.
+        Void* SubmissionMap = nullptr;
+        size_t SubmissionSize = 0;
+        Void* CompletionMap = nullptr;
+        size_t CompletionSize = 0;
+        io_uring_sqe* Entries = nullptr;
+        size_t EntriesSize = 0;
+        // The fields of the rings, inside the mappings.
+        uInt* SubmissionTail = nullptr;
+        uInt* SubmissionMask = nullptr;
+        uInt* SubmissionArray = nullptr;
+        uInt* CompletionHead = nullptr;
+        uInt* CompletionTail = nullptr;
+        uInt* CompletionMask = nullptr;
+        io_uring_cqe* Completions = nullptr;
+        // The number of entries added to the submission ring that haven't been handed to the kernel yet.
+        uInt Unsubmitted = 0;
+        #endif
+    };
+
+    // ----------------------------------------------------------------------------------------
+    // Mark a request as completed and call its callback.
+    static Void FileQueueComplete(FileQueue& queue, FileQueue::Request& request)
+    {
+        request.Done = true;
+        queue.Pending--;
+        // -- //
+        if(request.Callback) { request.Callback(request); }
+    };
+
+    // ----------------------------------------------------------------------------------------
+    // Service requests on a thread of the pool until the queue is released.
+    static Void FileQueueWork(FileQueueBackend* backend)
+    {
+        while(true)
+        {
+            // Wait for a request, or for the queue to be released.
+            backend->IncomingCount.acquire();
+            // -- //
+            if(backend->Stopping.load()) { return; }
+
+            // Only the submitting thread pushes requests, so every counted request can be popped.
+            FileQueue::Request* request;
+            backend->Incoming.Pop(request);
+
+            // Read the data and hand the request back.
+            request->Result = request->Source->ReadAt(request->Offset, request->Destination, request->Size);
+            backend->Completed.Push(request);
+            backend->CompletedCount.release();
+        }
+    };
+
+    // ----------------------------------------------------------------------------------------
+    // Collect a request completed by the pool. Only called after taking a count from CompletedCount.
+    static Void FileQueueCollect(FileQueue& queue, FileQueueBackend* backend)
+    {
+        // Threads of the pool can finish pushing out of order, so the request counted may sit behind one that's still being pushed.
+        FileQueue::Request* request;
+        while(!backend->Completed.Pop(request)) { std::this_thread::yield(); }
+        // -- //
+        FileQueueComplete(queue, *request);
+    };
+
+    #if defined(__linux__)
+    // ----------------------------------------------------------------------------------------
+    // Unmap and close the ring.
+    static Void FileQueueClose(FileQueueBackend* backend)
+    {
+        if(backend->Entries) { munmap(backend->Entries, backend->EntriesSize); }
+        if(backend->CompletionMap && (backend->CompletionMap != backend->SubmissionMap)) { munmap(backend->CompletionMap, backend->CompletionSize); }
+        if(backend->SubmissionMap) { munmap(backend->SubmissionMap, backend->SubmissionSize); }
+        if(backend->Ring >= 0) { close(backend->Ring); }
+        // -- //
+        backend->Ring = -1;
+    };
+
+    // ----------------------------------------------------------------------------------------
+    // Create and map a ring with the specified number of entries. Returns false if io_uring isn't available.
+    static Bool FileQueueOpen(FileQueueBackend* backend, Int entries)
+    {
+        // Create the ring.
+        io_uring_params parameters;
+        Memory::Zero(&parameters, sizeof(parameters));
+        // -- //
+        backend->Ring = int(syscall(__NR_io_uring_setup, uInt(entries), &parameters));
+        if(backend->Ring < 0) { backend->Ring = -1; return false; }
+
+        // Plain reads (rather than vectored ones) arrived in the same kernel release as this feature.
+        if(!(parameters.features & IORING_FEAT_RW_CUR_POS)) { FileQueueClose(backend); return false; }
+
+        // Map the rings; Newer kernels map both rings with a single mapping.
+        backend->SubmissionSize = parameters.sq_off.array + parameters.sq_entries * sizeof(uInt);
+        backend->CompletionSize = parameters.cq_off.cqes + parameters.cq_entries * sizeof(io_uring_cqe);
+        backend->EntriesSize = parameters.sq_entries * sizeof(io_uring_sqe);
+        // -- //
+        Bool single = parameters.features & IORING_FEAT_SINGLE_MMAP;
+        if(single && (backend->CompletionSize > backend->SubmissionSize)) { backend->SubmissionSize = backend->CompletionSize; }
+
+        // Helper for mapping part of the ring.
+        auto map = [&](size_t size, off_t offset) -> Void*
+        {
+            Void* mapping = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, backend->Ring, offset);
+            // -- //
+            return (mapping != MAP_FAILED) ? mapping : nullptr;
+        };
+        backend->SubmissionMap = map(backend->SubmissionSize, IORING_OFF_SQ_RING);
+        backend->CompletionMap = single ? backend->SubmissionMap : map(backend->CompletionSize, IORING_OFF_CQ_RING);
+        backend->Entries = (io_uring_sqe*)map(backend->EntriesSize, IORING_OFF_SQES);
+        // -- //
+        if(!backend->SubmissionMap || !backend->CompletionMap || !backend->Entries) { FileQueueClose(backend); return false; }
+
+        // Locate the fields of the rings.
+        Byte* submission = (Byte*)backend->SubmissionMap;
+        Byte* completion = (Byte*)backend->CompletionMap;
+        // -- //
+        backend->SubmissionTail = (uInt*)(submission + parameters.sq_off.tail);
+        backend->SubmissionMask = (uInt*)(submission + parameters.sq_off.ring_mask);
+        backend->SubmissionArray = (uInt*)(submission + parameters.sq_off.array);
+        backend->CompletionHead = (uInt*)(completion + parameters.cq_off.head);
+        backend->CompletionTail = (uInt*)(completion + parameters.cq_off.tail);
+        backend->CompletionMask = (uInt*)(completion + parameters.cq_off.ring_mask);
+        backend->Completions = (io_uring_cqe*)(completion + parameters.cq_off.cqes);
+
+        return true;
+    };
+
+    // ----------------------------------------------------------------------------------------
+    // Add an entry reading the unread part of a request to the submission ring.
+    static Void FileQueuePrepare(FileQueueBackend* backend, FileQueue::Request& request)
+    {
+        // Helpers
+        uInt tail = *backend->SubmissionTail;
+        uInt index = tail & *backend->SubmissionMask;
+        Long remaining = request.Size - request.Result;
+        io_uring_sqe& entry = backend->Entries[index];
+
+        // Fill in the entry. File handles hold the descriptor offset by one (see File::Open()).
+        Memory::Zero(&entry, sizeof(entry));
+        entry.opcode = IORING_OP_READ;
+        entry.fd = int(intptr_t(request.Source->Handle) - 1);
+        entry.off = uLong(request.Offset + request.Result);
+        entry.addr = uLong(uintptr_t((Byte*)request.Destination + request.Result));
+        entry.len = uInt((remaining < fileQueueChunk) ? remaining : fileQueueChunk);
+        entry.user_data = uLong(uintptr_t(&request));
+
+        // Publish the entry to the kernel.
+        backend->SubmissionArray[index] = index;
+        std::atomic_ref<uInt>(*backend->SubmissionTail).store(tail + 1, std::memory_order_release);
+        backend->Unsubmitted++;
+    };
+
+    // ----------------------------------------------------------------------------------------
+    // Hand the unsubmitted entries to the kernel, and optionally wait for a completion.
+    static Void FileQueueEnter(FileQueueBackend* backend, Bool wait)
+    {
+        while(true)
+        {
+            long result = syscall(__NR_io_uring_enter, backend->Ring, backend->Unsubmitted, wait ? 1 : 0, wait ? IORING_ENTER_GETEVENTS : 0, nullptr, 0);
+
+            // Retry if interrupted; Otherwise stop once every entry has been consumed.
+            if(result >= 0)
+            {
+                backend->Unsubmitted -= uInt(result);
+                // -- //
+                if(!backend->Unsubmitted) { return; }
+            }
+            else if((errno != EINTR) && (errno != EAGAIN))
+            {
+                // Debug check
+                Assert(false, "There was a problem submitting reads to io_uring.");
+                return;
+            }
+        }
+    };
+
+    // ----------------------------------------------------------------------------------------
+    // Collect the entries in the completion ring. Requests that were only partly read are resubmitted. Returns the number completed.
+    static Int FileQueueReap(FileQueue& queue, FileQueueBackend* backend)
+    {
+        // Helpers
+        Int completed = 0;
+        uInt head = *backend->CompletionHead;
+        uInt tail = std::atomic_ref<uInt>(*backend->CompletionTail).load(std::memory_order_acquire);
+
+        for(; head != tail; head++)
+        {
+            // Read the entry and hand its slot back to the kernel.
+            io_uring_cqe& entry = backend->Completions[head & *backend->CompletionMask];
+            FileQueue::Request& request = *(FileQueue::Request*)uintptr_t(entry.user_data);
+            int result = entry.res;
+            // -- //
+            std::atomic_ref<uInt>(*backend->CompletionHead).store(head + 1, std::memory_order_release);
+
+            // Retry interrupted reads.
+            if((result == -EINTR) || (result == -EAGAIN)) { FileQueuePrepare(backend, request); continue; }
+
+            // Debug check
+            Assert(result >= 0, "There was a problem reading data from a file.");
+
+            // Read the rest of the request if the read was short but didn't reach the end of the file.
+            if(result > 0)
+            {
+                request.Result += result;
+                // -- //
+                if(request.Result < request.Size) { FileQueuePrepare(backend, request); continue; }
+            }
+
+            FileQueueComplete(queue, request);
+            completed++;
+        }
+
+        return completed;
+    };
+    #endif
+
+    // ----------------------------------------------------------------------------------------
+    Void FileQueue::Expand(Int capacity, Int threads, Bool pooled)
+    {
+        // Debug checks
+        Assert(!Handle, "Attempting to create a file queue that has already been created.");
+        Assert(capacity > 0, "Cannot create file queues without room for any requests.");
+
+        // The rings and queues are sized to a power of two.
+        Int size = 1;
+        while(size < capacity) { size <<= 1; }
+
+        // Create the backend state.
+        FileQueueBackend* backend = Memory::Request<FileQueueBackend>();
+        Handle = backend;
+        Capacity = capacity;
+
+        // Prefer io_uring where it's available.
+        #if defined(__linux__)
+        if(!pooled && FileQueueOpen(backend, size)) { return; }
+        #endif
+
+        // Otherwise start the pool.
+        if(threads <= 0) { threads = Int(std::thread::hardware_concurrency()); }
+        if(threads <= 0) { threads = 1; }
+        // -- //
+        backend->Incoming.Expand(size);
+        backend->Completed.Expand(size);
+        backend->Workers = (std::thread*)Memory::Request(sizeof(std::thread) * threads);
+        backend->WorkerCount = threads;
+        for(Int i = 0; i < threads; i++) { new(backend->Workers + i)std::thread(FileQueueWork, backend); }
+    };
+
+    // ----------------------------------------------------------------------------------------
+    Void FileQueue::Release()
+    {
+        // -- //
+        if(!Handle) { return; }
+
+        // Let the reads in flight finish, since they write into the requests' destinations.
+        Finish();
+
+        FileQueueBackend* backend = (FileQueueBackend*)Handle;
+        // Close the ring.
+        #if defined(__linux__)
+        FileQueueClose(backend);
+        #endif
+
+        // Stop the pool.
+        if(backend->Workers)
+        {
+            backend->Stopping.store(true);
+            backend->IncomingCount.release(backend->WorkerCount);
+            // -- //
+            for(Int i = 0; i < backend->WorkerCount; i++) { backend->Workers[i].join(); backend->Workers[i].~thread(); }
+            Memory::Free(backend->Workers);
+        }
+
+        // Release the backend state.
+        backend->~FileQueueBackend();
+        Memory::Free(backend);
+        // -- //
+        Handle = nullptr;
+        Capacity = 0;
+    };
+
+    // ----------------------------------------------------------------------------------------
+    Bool FileQueue::Submit(Request& request)
+    {
+        // Debug checks
+        Assert(Handle, "Attempting to submit a read to a file queue that hasn't been created.");
+        Assert(request.Source && request.Source->Handle, "Attempting to read from a file that isn't open.");
+        Assert((request.Offset >= 0) && (request.Size >= 0), "Attempting to read a negative range of a file.");
+
+        // -- //
+        if(Pending == Capacity) { return false; }
+
+        // Reset the results.
+        request.Result = 0;
+        request.Done = false;
+        Pending++;
+
+        FileQueueBackend* backend = (FileQueueBackend*)Handle;
+        // Add the request to the submission ring.
+        #if defined(__linux__)
+        if(backend->Ring >= 0) { FileQueuePrepare(backend, request); return true; }
+        #endif
+
+        // Or hand it to the pool.
+        backend->Incoming.Push(&request);
+        backend->IncomingCount.release();
+        // -- //
+        return true;
+    };
+
+    // ----------------------------------------------------------------------------------------
+    Int FileQueue::Poll()
+    {
+        // -- //
+        if(!Handle) { return 0; }
+
+        FileQueueBackend* backend = (FileQueueBackend*)Handle;
+        // Submit the queued entries and collect the completed ones.
+        #if defined(__linux__)
+        if(backend->Ring >= 0)
+        {
+            if(backend->Unsubmitted) { FileQueueEnter(backend, false); }
+            // -- //
+            return FileQueueReap(*this, backend);
+        }
+        #endif
+
+        // Collect the requests completed by the pool.
+        Int completed = 0;
+        for(; backend->CompletedCount.try_acquire(); completed++) { FileQueueCollect(*this, backend); }
+        // -- //
+        return completed;
+    };
+
+    // ----------------------------------------------------------------------------------------
+    Int FileQueue::Wait()
+    {
+        // -- //
+        if(!Pending) { return 0; }
+
+        FileQueueBackend* backend = (FileQueueBackend*)Handle;
+        // Wait on the ring until an entry completes a request; Partly read requests are resubmitted rather than completed.
+        #if defined(__linux__)
+        if(backend->Ring >= 0)
+        {
+            Int completed = Poll();
+            // -- //
+            while(!completed)
+            {
+                FileQueueEnter(backend, true);
+                completed = FileQueueReap(*this, backend);
+            }
+            return completed;
+        }
+        #endif
+
+        // Wait for the pool to complete a request, then collect any others that are done.
+        backend->CompletedCount.acquire();
+        FileQueueCollect(*this, backend);
+        // -- //
+        return 1 + Poll();
+    };
+}
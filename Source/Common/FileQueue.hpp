@@ -0,0 +1,94 @@
+/*
+-------------------------------------------------------------------------------
+    Filename: Common/FileQueue.hpp
+-------------------------------------------------------------------------------
+*/
+
+// Header guard
+#pragma once
+// Includes
+#include "..\Common.hpp"
+#include "..\Common\File.hpp"
+
+// --------------------------------------------------------------------------------------------
+namespace R2D
+{
+    // ----------------------------------------------------------------------------------------
+    // Queue of asynchronous file reads. Many reads can be submitted at once and are serviced concurrently, so loading lots of small files
+    // is limited by the disk's throughput rather than the latency of each read. On Linux the reads go through io_uring, submitting a whole
+    // batch with a single system call; Elsewhere (or if io_uring isn't available) a pool of threads services them with File::ReadAt().
+    // Submit(), Poll(), Wait() and Finish() must all be called from the same thread, which is also the thread callbacks run on.
+    class FileQueue
+    {
+    public:
+        // Types
+
+        struct Request;
+        // Function called when a request completes.
+        typedef Void(*Completion)(Request& request);
+
+        // A read request. The request and its destination must stay valid until it completes.
+        struct Request
+        {
+            // The file to read from. Must be open with read access until the request completes.
+            const File* Source;
+            // The offset in the file to start reading from.
+            Long Offset;
+            // The number of bytes to read.
+            Long Size;
+            // The buffer to read into, with room for Size bytes.
+            Void* Destination;
+            // Function to call when the request completes, or a nullptr.
+            Completion Callback;
+            // User data for the callback.
+            Void* Context;
+
+            // The number of bytes read, which is less than Size if the end of the file was reached. Valid once Done is set.
+            Long Result;
+            // Set when the request has completed.
+            Bool Done;
+        };
+
+    public:
+        // Members
+
+        // Handle to the backend servicing the requests.
+        Void* Handle;
+        // The maximum number of requests that can be in flight at once.
+        Int Capacity;
+        // The number of requests submitted that haven't completed yet.
+        Int Pending;
+
+    public:
+        // Constructors
+
+        // Default constructor.
+        FileQueue() : Handle(nullptr), Capacity(0), Pending(0) {};
+        // Copy constructor.
+        FileQueue(const FileQueue& other) = delete;
+        // Move constructor.
+        FileQueue(FileQueue&& other) = delete;
+        // Destructor.
+        ~FileQueue() { Release(); };
+
+        // Methods
+
+        // Create the backend with room for capacity requests in flight. Threads sets the size of the thread pool used where io_uring
+        // isn't available; Zero uses one thread per hardware thread. Set pooled to use the pool even where io_uring is available, e.g.
+        // to check the behaviour of systems without it.
+        Void Expand(Int capacity, Int threads = 0, Bool pooled = false);
+        // Wait for the pending requests to complete and release the backend.
+        Void Release();
+
+        // Queue a read request. Returns false if capacity requests are already in flight, in which case some have to complete first.
+        // On Linux, queued requests are only handed to the kernel at the next Poll(), Wait() or Finish(), so submit them in batches.
+        Bool Submit(Request& request);
+        // Collect the completed requests without blocking, setting their Done flags and calling their callbacks. Returns the number collected.
+        Int Poll();
+        // Block until at least one request has completed, then collect the completed requests like Poll(). Returns immediately if
+        // no requests are pending.
+        Int Wait();
+        // Block until every pending request has completed.
+        Void Finish() { while(Pending) { Wait(); } };
+    };
+}
@@ -0,0 +1,204 @@
+/*
+-------------------------------------------------------------------------------
+    Filename: Common/FileWriter.cpp
+-------------------------------------------------------------------------------
+*/
+
+// Includes
+#include "..\Common\FileWriter.hpp"
+// -- //
+#include <semaphore>
+#include <thread>
+
+// --------------------------------------------------------------------------------------------
+namespace R2D
+{
+    // ----------------------------------------------------------------------------------------
+    // The state of a writer's background thread.
+    struct FileWriterBackground
+    {
+        // The thread writing the back buffer.
+        std::thread Thread;
+        // Signalled when the back buffer has been filled and is ready to be written.
+        std::binary_semaphore Ready{ 0 };
+        // Held while the back buffer is being written, and available once it can be filled again.
+        std::binary_semaphore Idle{ 1 };
+        // The number of bytes in the back buffer, and the offset in the file they go to.
+        Long Length = 0;
+        Long Position = 0;
+        // Set to make the thread exit.
+        Bool Stopping = false;
+    };
+
+    // ----------------------------------------------------------------------------------------
+    // Write the back buffer each time it's handed over, until the writer is closed.
+    static Void FileWriterWork(FileWriter* writer)
+    {
+        FileWriterBackground* background = (FileWriterBackground*)writer->Handle;
+        // -- //
+        while(true)
+        {
+            // Wait for a buffer, or for the writer to be closed.
+            background->Ready.acquire();
+            // -- //
+            if(background->Stopping) { return; }
+
+            // Write the buffer.
+            Long written = writer->Target->WriteAt(background->Position, writer->Back, background->Length);
+
+            // Debug check
+            Warning(written == background->Length, "The file had less bytes written to it than requested.");
+            // -- //
+            if(written != background->Length) { writer->Failed = true; }
+
+            // Hand the buffer back.
+            background->Idle.release();
+        }
+    };
+
+    // ----------------------------------------------------------------------------------------
+    // Hand the front buffer's contents to the file; Either write them, or swap buffers and have the background thread write them.
+    static Void FileWriterHand(FileWriter& writer)
+    {
+        FileWriterBackground* background = (FileWriterBackground*)writer.Handle;
+        // Write the buffer on the calling thread.
+        if(!background)
+        {
+            Long written = writer.Target->WriteAt(writer.Offset, writer.Front, writer.Count);
+
+            // Debug check
+            Warning(written == writer.Count, "The file had less bytes written to it than requested.");
+            // -- //
+            if(written != writer.Count) { writer.Failed = true; }
+        }
+        // Or wait for the back buffer to be written, swap the buffers and have the background thread write the full one.
+        else
+        {
+            background->Idle.acquire();
+            // -- //
+            Byte* swap = writer.Front; writer.Front = writer.Back; writer.Back = swap;
+            background->Length = writer.Count;
+            background->Position = writer.Offset;
+            background->Ready.release();
+        }
+
+        // Start the next block of data after this one.
+        writer.Offset += writer.Count;
+        writer.Count = 0;
+    };
+
+    // ----------------------------------------------------------------------------------------
+    // Wait for the background thread to finish writing the back buffer, if there is one.
+    static Void FileWriterWait(FileWriter& writer)
+    {
+        FileWriterBackground* background = (FileWriterBackground*)writer.Handle;
+        // -- //
+        if(background) { background->Idle.acquire(); background->Idle.release(); }
+    };
+
+    // ----------------------------------------------------------------------------------------
+    Void FileWriter::Open(File& file, Long capacity, Bool background)
+    {
+        // Debug checks
+        Assert(!Target, "Attempting to open a file writer that is already open.");
+        Assert(file.Handle, "Attempting to write to a file that isn't open.");
+        Assert(capacity > 0, "Cannot create file writers without room for any data.");
+
+        // Start at the file's position.
+        Target = &file;
+        Capacity = capacity;
+        Count = 0;
+        Offset = file.Position;
+        Failed = false;
+
+        // Allocate the buffers.
+        Front = (Byte*)Memory::Request(capacity);
+        // -- //
+        if(background)
+        {
+            Back = (Byte*)Memory::Request(capacity);
+            Handle = Memory::Request<FileWriterBackground>();
+            ((FileWriterBackground*)Handle)->Thread = std::thread(FileWriterWork, this);
+        }
+    };
+
+    // ----------------------------------------------------------------------------------------
+    Void FileWriter::Close()
+    {
+        // -- //
+        if(!Target) { return; }
+
+        // Write everything that's left.
+        Flush();
+
+        // Stop the background thread.
+        if(Handle)
+        {
+            FileWriterBackground* background = (FileWriterBackground*)Handle;
+            // -- //
+            background->Stopping = true;
+            background->Ready.release();
+            background->Thread.join();
+            background->~FileWriterBackground();
+            Memory::Free(background);
+            Handle = nullptr;
+        }
+
+        // Release the buffers and reset the members.
+        if(Front) { Memory::Free(Front); Front = nullptr; }
+        if(Back) { Memory::Free(Back); Back = nullptr; }
+        // -- //
+        Target = nullptr;
+        Capacity = 0;
+        Count = 0;
+        Offset = 0;
+    };
+
+    // ----------------------------------------------------------------------------------------
+    Void FileWriter::Flush()
+    {
+        // -- //
+        if(!Target) { return; }
+
+        // Hand over the buffered data and wait for it to be written.
+        if(Count) { FileWriterHand(*this); }
+        FileWriterWait(*this);
+
+        // Keep the file's position in step with the writer.
+        Target->Position = Offset;
+    };
+
+    // ----------------------------------------------------------------------------------------
+    Void FileWriter::Spill(const Void* data, Long size)
+    {
+        // Debug check
+        Assert(Target, "Attempting to write to a file writer that isn't open.");
+
+        // Data smaller than the buffer fills the buffer up, and the rest starts the next one; So every block handed over is full.
+        if(size < Capacity)
+        {
+            Long part = Capacity - Count;
+            // -- //
+            Memory::Copy(Front + Count, data, part);
+            Count = Capacity;
+            FileWriterHand(*this);
+            // -- //
+            Memory::Copy(Front, (const Byte*)data + part, size - part);
+            Count = size - part;
+            return;
+        }
+
+        // Larger data is written straight to the file, after the buffered data. The background thread has to finish first,
+        // since both threads would update the file's size.
+        if(Count) { FileWriterHand(*this); }
+        FileWriterWait(*this);
+        // -- //
+        Long written = Target->WriteAt(Offset, data, size);
+        Offset += size;
+
+        // Debug check
+        Warning(written == size, "The file had less bytes written to it than requested.");
+        // -- //
+        if(written != size) { Failed = true; }
+    };
+}
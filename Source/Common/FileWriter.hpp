@@ -0,0 +1,107 @@
+/*
+-------------------------------------------------------------------------------
+    Filename: Common/FileWriter.hpp
+-------------------------------------------------------------------------------
+*/
+
+// Header guard
+#pragma once
+// Includes
+#include "..\Common.hpp"
+#include "..\Common\File.hpp"
+#include "..\Common\Memory.hpp"
+#include "..\Common\String.hpp"
+#include "..\Common\StringView.hpp"
+
+// --------------------------------------------------------------------------------------------
+namespace R2D
+{
+    // ----------------------------------------------------------------------------------------
+    // Buffered writer for a file. Writes are gathered in a buffer and reach the file in large blocks, so writing many small objects
+    // doesn't cost a system call each. With a background thread, a full buffer is swapped with a second one and written while
+    // the caller keeps filling the other, so the caller only waits if it outpaces the disk.
+    // While a writer is open on a file, the file must only be written through the writer.
+    class FileWriter
+    {
+    public:
+        // Members
+
+        // Handle to the file being written to.
+        File* Target;
+        // The buffer being filled.
+        Byte* Front;
+        // The buffer being written by the background thread. Only allocated when writing in the background.
+        Byte* Back;
+        // The size of each buffer in bytes.
+        Long Capacity;
+        // The number of bytes in the front buffer.
+        Long Count;
+        // The offset in the file the front buffer's contents go to.
+        Long Offset;
+        // Handle to the background thread's state, or a nullptr when writing on the calling thread.
+        Void* Handle;
+        // Set if any block reached the file short, e.g. because the disk is full. Reset by Open() and still valid after Close().
+        Bool Failed;
+
+    public:
+        // Constructors
+
+        // Default constructor.
+        FileWriter() : Target(nullptr), Front(nullptr), Back(nullptr), Capacity(0), Count(0), Offset(0), Handle(nullptr), Failed(false) {};
+        // Copy constructor.
+        FileWriter(const FileWriter& other) = delete;
+        // Move constructor.
+        FileWriter(FileWriter&& other) = delete;
+        // Destructor.
+        ~FileWriter() { Close(); };
+
+        // Methods
+
+        // Start writing to a file at its current position, buffering up to capacity bytes at a time.
+        // If background is set, full buffers are written by a background thread instead of the calling thread.
+        Void Open(File& file, Long capacity = 1 << 16, Bool background = false);
+        // Write the remaining buffered data, wait for it to reach the file and stop writing to it. Moves the file's position past the data.
+        Void Close();
+
+        // Hand the buffered data to the file, and wait for every write to complete.
+        Void Flush();
+
+        // Write bytes to the file.
+        Void Write(const Void* data, Long size)
+        {
+            // Copy small writes into the buffer, and leave the rest to Spill().
+            if(size <= Capacity - Count)
+            {
+                Memory::Copy(Front + Count, data, size);
+                Count += size;
+            }
+            else { Spill(data, size); }
+        };
+        // Write an object to the file. Preferably, only call this for POD types that don't contain pointers.
+        template <typename Type> Void Write(const Type& object)
+        {
+            Write((const Void*)&object, sizeof(Type));
+        };
+        // Write an array of objects to the file.
+        template <typename Type> Void Write(const Type* objects, Long count)
+        {
+            Write((const Void*)objects, sizeof(Type) * count);
+        };
+        // Write a string's characters to the file.
+        Void Write(const String& string)
+        {
+            Write((const Void*)string.Data(), string.Length());
+        };
+        // Write a string's characters to the file.
+        Void Write(const StringView& string)
+        {
+            Write((const Void*)string.Data(), string.Length());
+        };
+
+    private:
+        // Methods
+
+        // Write data that doesn't fit in what's left of the buffer.
+        Void Spill(const Void* data, Long size);
+    };
+}
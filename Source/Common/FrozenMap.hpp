@@ -0,0 +1,432 @@
+/*
+-------------------------------------------------------------------------------
+    Filename: Common/FrozenMap.hpp
+-------------------------------------------------------------------------------
+*/
+
+// Header guard
+#pragma once
+// Includes
+#include "..\Common.hpp"
+#include "..\Common\Array.hpp"
+#include "..\Common\Hash.hpp"
+#include "..\Common\Map.hpp"
+#include "..\Common\Memory.hpp"
+#include <type_traits>
+
+// --------------------------------------------------------------------------------------------
+namespace R2D
+{
+    // ----------------------------------------------------------------------------------------
+    // Immutable hash map built once from a fixed set of keys. The keys are placed using a minimal perfect hash (hash-and-displace),
+    // so the keys and values are packed contiguously without any empty slots and every lookup is a single probe.
+    // The whole map lives in one flat blob (header, displacements, keys, values) that can be written out as-is and later
+    // opened in-place, e.g. directly from a mapped file, without rebuilding. Only trivially copyable types should be saved this way.
+    template <typename Key, typename Value> class FrozenMap
+    {
+    public:
+        // Constants
+
+        // Identifier at the start of every blob.
+        static constexpr uInt Magic = 0x4E5A5246; // "FRZN"
+        // The average number of keys per displacement bucket. Lower values build faster but take more memory.
+        static constexpr Int Load = 4;
+
+        // Types
+
+        // The header at the start of the blob. Offsets are in bytes from the start of the blob.
+        struct Header
+        {
+            // Identifies the blob as a frozen map.
+            uInt Magic;
+            // The number of entries in the map.
+            Int Count;
+            // The number of displacement buckets.
+            Int Buckets;
+            // The seed the keys were hashed with.
+            uInt Seed;
+            // The size of the key and value types the blob was built with, used to validate opened blobs.
+            Int KeySize;
+            Int ValueSize;
+            // Offsets to the displacement, key and value arrays.
+            Int Displacements;
+            Int Keys;
+            Int Values;
+        };
+
+    public:
+        // Members
+
+        // The blob containing the map.
+        Byte* Data;
+        // The size of the blob in bytes.
+        Long Size;
+        // Array of displacements, one per bucket.
+        const uInt* Displacements;
+        // Array of keys, indexed by slot.
+        const Key* Keys;
+        // Array of values, indexed by slot.
+        Value* Values;
+        // The number of entries in the map.
+        Int Count;
+        // The number of displacement buckets.
+        Int Buckets;
+        // The seed the keys are hashed with.
+        uInt Seed;
+        // Flag denoting the map owns the blob and the values in it, rather than referencing an external blob.
+        Bool Owned;
+
+    public:
+        // Constructors
+
+        // Default constructor.
+        FrozenMap() : Data(nullptr), Size(0), Displacements(nullptr), Keys(nullptr), Values(nullptr), Count(0), Buckets(0), Seed(0), Owned(false) {};
+        // Copy constructor.
+        FrozenMap(const FrozenMap& other) = delete;
+        // Move constructor.
+        FrozenMap(FrozenMap&& other) : Data(other.Data), Size(other.Size), Displacements(other.Displacements), Keys(other.Keys), Values(other.Values), Count(other.Count), Buckets(other.Buckets), Seed(other.Seed), Owned(other.Owned)
+        {
+            other.Data = nullptr; other.Size = 0; other.Displacements = nullptr; other.Keys = nullptr; other.Values = nullptr; other.Count = 0; other.Buckets = 0; other.Seed = 0; other.Owned = false;
+        };
+        // Destructor.
+        ~FrozenMap() { Release(); };
+
+        // Methods
+
+        // Build the map from an array of unique keys, moving the values in from the parallel values array.
+        Void Build(const Key* keys, Value* values, Int count)
+        {
+            Array<Int> placement;
+            // Place the keys, then move the values into the slots their keys were placed in.
+            Place(keys, count, placement);
+            // -- //
+            for(Int i = 0; i < Count; i++) { new(Values + i)Value(R2D::Move(values[placement[i]])); }
+        };
+
+        // Build the map from a list of unique keys, default constructing the values.
+        // Index() can then be used as a minimal perfect hash over the keys, i.e. to index parallel arrays.
+        Void Build(const Key* keys, Int count)
+        {
+            Array<Int> placement;
+            // Place the keys and construct the values.
+            Place(keys, count, placement);
+            // -- //
+            for(Int i = 0; i < Count; i++) { new(Values + i)Value(); }
+        };
+
+        // Build the map from the entries of a regular map, moving its values over. The map should be released afterwards.
+        Void Build(Map<Key, Value>& map)
+        {
+            Array<Key> keys;
+            Array<Value*> values;
+            // Gather the map's keys and the locations of their values.
+            keys.Reserve(map.Count);
+            values.Reserve(map.Count);
+            // -- //
+            for(auto iterator = map.First(); !iterator.Last(); iterator.Next())
+            {
+                keys.Append(map.Keys[iterator.Index]);
+                values.Append(map.Data + iterator.Index);
+            }
+
+            // Debug check
+            Assert(keys.Count == map.Count, "The map's entries couldn't all be enumerated, so the frozen map would be missing some.");
+
+            Array<Int> placement;
+            // Place the keys, then move the values into the slots their keys were placed in.
+            Place(keys.Data, keys.Count, placement);
+            // -- //
+            for(Int i = 0; i < Count; i++) { new(Values + i)Value(R2D::Move(*values[placement[i]])); }
+
+            // Destruct the gathered copies of the keys; The map holds copies of its own.
+            for(Int i = 0; i < keys.Count; i++) { keys[i].~Key(); }
+        };
+
+        // Reference a blob that was previously built and saved, without copying it. Returns false if the blob isn't valid for this map type.
+        // The blob must outlive the map and must remain aligned as it was saved, i.e. to at least 16 bytes.
+        Bool Open(const Void* blob, Long size)
+        {
+            // Debug check
+            static_assert(std::is_trivially_copyable_v<Key> && std::is_trivially_copyable_v<Value>, "Only frozen maps of trivially copyable types can be opened from a blob.");
+            Assert(!Data, "Attempting to open a blob with a frozen map that already contains entries.");
+
+            // Validate the header.
+            const Header* header = (const Header*)blob;
+            // -- //
+            if(!blob || (size < Long(sizeof(Header)))) { return false; }
+            if((header->Magic != Magic) || (header->KeySize != Int(sizeof(Key))) || (header->ValueSize != Int(sizeof(Value)))) { return false; }
+            if((header->Count < 0) || (header->Buckets < 0) || (header->Count && !header->Buckets)) { return false; }
+
+            // Validate every array lies after the header, is aligned for its type and fits inside the blob.
+            auto fits = [size](Int offset, Long stride, Int count, Long alignment)
+            {
+                return (offset >= Int(sizeof(Header))) && !(offset % alignment) && (offset + stride * count <= size);
+            };
+            // -- //
+            if(!fits(header->Displacements, sizeof(uInt), header->Buckets, alignof(uInt))) { return false; }
+            if(!fits(header->Keys, sizeof(Key), header->Count, alignof(Key))) { return false; }
+            if(!fits(header->Values, sizeof(Value), header->Count, alignof(Value))) { return false; }
+
+            // Point into the blob.
+            Data = (Byte*)blob;
+            Size = size;
+            Owned = false;
+            Count = header->Count;
+            Buckets = header->Buckets;
+            Seed = header->Seed;
+            Displacements = (const uInt*)(Data + header->Displacements);
+            Keys = (const Key*)(Data + header->Keys);
+            Values = (Value*)(Data + header->Values);
+            // -- //
+            return true;
+        };
+
+        // Release the memory, keys and values owned by the map. Referenced blobs are left untouched.
+        Void Release()
+        {
+            // Destruct the keys and values and free the blob if the map owns them.
+            if(Data && Owned)
+            {
+                for(Int i = 0; i < Count; i++) { Keys[i].~Key(); Values[i].~Value(); }
+                // -- //
+                Memory::Free(Data);
+            }
+            // -- //
+            Data = nullptr;
+            Size = 0;
+            Displacements = nullptr;
+            Keys = nullptr;
+            Values = nullptr;
+            Count = 0;
+            Buckets = 0;
+            Seed = 0;
+            Owned = false;
+        };
+
+        // Lookup a key and return its slot index, which is unique and less than Count. Returns -1 if the key isn't in the map.
+        Int Index(const Key& key) const
+        {
+            // Return if the map is empty.
+            if(!Count) { return -1; }
+
+            // Hash the key, displace it by its bucket's displacement and confirm the key in the resulting slot.
+            uLong hash = Digest(key, Seed);
+            Int slot = Slot(hash, Displacements[Bucket(hash, Buckets)], Count);
+            // -- //
+            return (Keys[slot] == key) ? slot : -1;
+        };
+
+        // Lookup an entry and return a pointer to its payload if one is found.
+        const Value* Find(const Key& key) const
+        {
+            Int slot = Index(key);
+            // -- //
+            return (slot >= 0) ? Values + slot : nullptr;
+        };
+
+    private:
+        // Internal methods
+
+        // Static; Hash a key with a seed. The hash is 64-bit, the upper half selects the key's bucket and the lower half its slot.
+        // 32-bit hashes alone would collide too often in large maps, and two keys whose hashes collide can never be placed in distinct slots.
+        // Only keys whose bytes fully define them are hashed byte-wise. Any other key (strings, paths, structs with padding) is hashed
+        // through its Hash::FNV32 overload the same way Map does, which limits such maps to the key counts a 32-bit hash can tell apart.
+        static uLong Digest(const Key& key, uInt seed)
+        {
+            // Hash keys that can't be hashed byte-wise through their overload.
+            if constexpr(!std::has_unique_object_representations_v<Key>)
+            {
+                return Mix(Mix((uLong(seed) * 0x9E3779B97F4A7C15) ^ Hash::FNV32(key)) + 0x9E3779B97F4A7C15);
+            }
+
+            // Helpers
+            auto bytes = (const uByte*)&key;
+            uLong hash = (uLong(seed) * 0x9E3779B97F4A7C15) ^ sizeof(Key);
+            Int i = 0;
+
+            // Mix the key in 8 bytes at a time.
+            for(; i + 8 <= Int(sizeof(Key)); i += 8)
+            {
+                uLong block;
+                Memory::Copy(&block, bytes + i, 8);
+                // -- //
+                hash = Mix(hash ^ block);
+            }
+
+            // Mix in the remaining bytes.
+            if(i < Int(sizeof(Key)))
+            {
+                uLong tail = 0;
+                for(Int j = 0; i + j < Int(sizeof(Key)); j++) { tail |= uLong(bytes[i + j]) << (j * 8); }
+                // -- //
+                hash = Mix(hash ^ tail);
+            }
+            // -- //
+            return Mix(hash + 0x9E3779B97F4A7C15);
+        };
+
+        // Static; Scramble a 64-bit value (MurmurHash3's finalizer).
+        static uLong Mix(uLong value)
+        {
+            value ^= value >> 33; value *= 0xFF51AFD7ED558CCD;
+            value ^= value >> 33; value *= 0xC4CEB9FE1A85EC53;
+            value ^= value >> 33;
+            // -- //
+            return value;
+        };
+
+        // Static; Map a value onto [0, range) without a division.
+        static Int Range(uInt value, Int range)
+        {
+            return Int((uLong(value) * uLong(range)) >> 32);
+        };
+
+        // Static; Compute the bucket a hash belongs to.
+        static Int Bucket(uLong hash, Int buckets)
+        {
+            return Range(uInt(hash >> 32), buckets);
+        };
+
+        // Static; Compute the slot a hash is placed in under the specified displacement.
+        static Int Slot(uLong hash, uInt displacement, Int count)
+        {
+            return Range(uInt(Mix(uInt(hash) ^ (uLong(displacement) << 32))), count);
+        };
+
+        // Compute the placement of the keys, allocate the blob and copy the keys into their slots.
+        // Outputs, for every slot, the index of the input key that was placed there. The values are left for the caller to construct.
+        Void Place(const Key* keys, Int count, Array<Int>& placement)
+        {
+            // Debug check
+            Assert(!Data, "Attempting to build a frozen map that already contains entries.");
+
+            // Nothing to do for an empty map.
+            if(count <= 0) { return; }
+
+            // Helpers
+            Int buckets = ((count - 1) / Load) + 1;
+
+            // Hash the keys and group them by bucket (a counting sort). Two keys in the same bucket whose slot hashes are equal
+            // can never be placed apart, so should that happen, try again with a different seed.
+            Array<uLong> hashes;
+            Array<Int> starts, members, cursor;
+            hashes.Reserve(count);
+            starts.Reserve(buckets + 1);
+            members.Reserve(count);
+            cursor.Reserve(buckets);
+            // -- //
+            uInt seed = 0;
+            for(Bool unique = false; !unique; seed++)
+            {
+                // Debug check
+                Assert(seed < 64, "Cannot build the frozen map. The keys keep hashing to the same value, they're likely not unique.");
+
+                hashes.Count = starts.Count = cursor.Count = 0;
+                // -- //
+                for(Int i = 0; i <= buckets; i++) { starts.Append(0); }
+                for(Int i = 0; i < count; i++) { hashes.Append(Digest(keys[i], seed)); starts[Bucket(hashes[i], buckets) + 1]++; }
+                for(Int i = 0; i < buckets; i++) { starts[i + 1] += starts[i]; cursor.Append(starts[i]); }
+                // -- //
+                members.Count = count;
+                for(Int i = 0; i < count; i++) { members[cursor[Bucket(hashes[i], buckets)]++] = i; }
+
+                // Check the hashes within every bucket are unique.
+                unique = true;
+                for(Int i = 0; (i < buckets) && unique; i++)
+                {
+                    for(Int a = starts[i]; (a < starts[i + 1]) && unique; a++)
+                    {
+                        for(Int b = starts[i]; (b < a) && unique; b++) { unique = uInt(hashes[members[a]]) != uInt(hashes[members[b]]); }
+                    }
+                }
+            }
+            seed--;
+
+            // Order the buckets from largest to smallest, since the largest are the hardest to place (also a counting sort).
+            Array<Int> order;
+            order.Reserve(buckets);
+            {
+                Int largest = 0;
+                for(Int i = 0; i < buckets; i++) { Int size = starts[i + 1] - starts[i]; largest = size > largest ? size : largest; }
+                // -- //
+                for(Int size = largest; size > 0; size--)
+                {
+                    for(Int i = 0; i < buckets; i++) { if((starts[i + 1] - starts[i]) == size) { order.Append(i); } }
+                }
+            }
+
+            // Allocate the blob, aligning every array to 16 bytes.
+            Int offsets[3];
+            offsets[0] = (Int(sizeof(Header)) + 15) & ~15;
+            offsets[1] = (offsets[0] + Int(sizeof(uInt)) * buckets + 15) & ~15;
+            offsets[2] = (offsets[1] + Int(sizeof(Key)) * count + 15) & ~15;
+            // -- //
+            Size = offsets[2] + Long(sizeof(Value)) * count;
+            Data = (Byte*)Memory::Request(Size);
+            Memory::Zero(Data, Size);
+            Owned = true;
+
+            // Write the header and assign the array pointers.
+            Header* header = new(Data)Header();
+            header->Magic = Magic;
+            header->Count = Count = count;
+            header->Buckets = Buckets = buckets;
+            header->Seed = Seed = seed;
+            header->KeySize = sizeof(Key);
+            header->ValueSize = sizeof(Value);
+            header->Displacements = offsets[0];
+            header->Keys = offsets[1];
+            header->Values = offsets[2];
+            // -- //
+            uInt* displacements = (uInt*)(Data + offsets[0]);
+            Displacements = displacements;
+            Keys = (const Key*)(Data + offsets[1]);
+            Values = (Value*)(Data + offsets[2]);
+
+            // Prepare the slot placement table, where -1 denotes a free slot.
+            placement.Reserve(count);
+            placement.Count = count;
+            for(Int i = 0; i < count; i++) { placement[i] = -1; }
+
+            // Place each bucket's keys by searching for a displacement that sends all of them into free, distinct slots.
+            Int slots[64];
+            for(Int i = 0; i < order.Count; i++)
+            {
+                // Helpers
+                Int bucket = order[i];
+                Int first = starts[bucket];
+                Int size = starts[bucket + 1] - first;
+
+                // Debug check
+                Assert(size <= 64, "Cannot build the frozen map. Too many keys hashed into the same bucket.");
+
+                // Try displacements until one fits.
+                uInt displacement = 0;
+                for(;; displacement++)
+                {
+                    // Debug check
+                    Assert(displacement < (1u << 24), "Cannot build the frozen map. No displacement could be found for a bucket.");
+
+                    Bool fits = true;
+                    // Compute the slots of the bucket's keys, checking they're free and don't collide with each other.
+                    for(Int j = 0; (j < size) && fits; j++)
+                    {
+                        slots[j] = Slot(hashes[members[first + j]], displacement, count);
+                        fits = placement[slots[j]] < 0;
+                        // -- //
+                        for(Int k = 0; (k < j) && fits; k++) { fits = slots[k] != slots[j]; }
+                    }
+                    // -- //
+                    if(fits) { break; }
+                }
+
+                // Claim the slots.
+                displacements[bucket] = displacement;
+                for(Int j = 0; j < size; j++) { placement[slots[j]] = members[first + j]; }
+            }
+
+            // Copy the keys into their slots.
+            for(Int i = 0; i < count; i++) { new((Key*)Keys + i)Key(keys[placement[i]]); }
+        };
+    };
+}
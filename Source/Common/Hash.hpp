@@ -8,22 +8,24 @@
 #pragma once
 // Includes
 #include "..\Common.hpp"
+#include "..\Common\String.hpp"
+#include "..\Common\StringView.hpp"
 
 // --------------------------------------------------------------------------------------------
 namespace R2D
 {
+    // Forward declarations.
+    class Path;
+
     // ----------------------------------------------------------------------------------------
     namespace Hash
     {
-        // 32-bit FNV-1a (Fowler/Noll/Vo) hash function.
-        inline uInt FNV32(const Void* data, Int size)
+        // 32-bit FNV-1a (Fowler/Noll/Vo) hash function. Continues hashing from a previous result, as if the data was appended to what it hashed.
+        inline uInt FNV32(const Void* data, Int size, uInt hash)
         {
             // Helper
             auto bytes = (const Byte*)data;
 
-            // Starting hash offset basis.
-            uInt hash = 2166136261;
-
             // Loop over every byte in the type and perform the hashing operation.
             for(Int i = 0; i < size; i++)
             {
@@ -35,6 +37,26 @@ namespace R2D
             return hash;
         };
 
+        // 32-bit FNV-1a (Fowler/Noll/Vo) hash function.
+        inline uInt FNV32(const Void* data, Int size)
+        {
+            // Start from the hash offset basis.
+            return FNV32(data, size, 2166136261);
+        };
+
+        // 64-bit FNV-1a (Fowler/Noll/Vo) hash function. Used for hashing file contents, where 32 bits would collide too easily.
+        inline uLong FNV64(const Void* data, Long size)
+        {
+            // Helpers
+            auto bytes = (const uByte*)data;
+            uLong hash = 14695981039346656037ULL;
+
+            // Loop over every byte and perform the hashing operation.
+            for(Long i = 0; i < size; i++) { hash = (hash ^ bytes[i]) * 1099511628211ULL; }
+            // -- //
+            return hash;
+        };
+
         // 32-bit FNV-1a (Fowler/Noll/Vo) hash function. Can be used during compile-time with C-strings. Doesn't include the null byte.
         template <size_t count> constexpr uInt FNV32(const char(&string)[count])
         {
@@ -58,5 +80,158 @@ namespace R2D
             // Parse some type information and simply call the normal FNV32 function.
             return FNV32(&object, sizeof(Type));
         };
+
+        // Hash the characters referenced by a view, rather than the view itself.
+        inline uInt FNV32(const StringView& view)
+        {
+            return FNV32(view.Data(), view.Length());
+        };
+
+        // Hash the characters of a string, rather than the string object (which may point to them).
+        inline uInt FNV32(const String& string)
+        {
+            return FNV32(string.Data(), string.Length());
+        };
+
+        // Use the hash a path keeps of its characters, rather than hashing the path object.
+        extern uInt FNV32(const Path& path);
+
+        // ------------------------------------------------------------------------------------
+        // Perfect hash table built at compile-time from a fixed set of keywords. Maps each keyword to its dense index
+        // in the list it was built from, so recognizing a keyword is a single table probe rather than a chain of comparisons.
+        // Fails to compile if two of the keywords share the same hash, or if no collision-free seed could be found.
+        template <Int count> class Perfect
+        {
+        public:
+            // Constants
+
+            // The number of bits used to address the table. Sized so that the table has at least twice as many slots as keywords.
+            static constexpr Int Bits = []() { Int bits = 1; while((1 << bits) < (count * 2)) { bits++; } return bits; }();
+            // The number of slots in the table.
+            static constexpr Int Capacity = 1 << Bits;
+
+        public:
+            // Members
+
+            // The keywords the table was built from.
+            const char* Keywords[count];
+            // The number of characters in each keyword (not including the null-byte).
+            Int Lengths[count];
+            // The 32-bit FNV-1a hashes of the keywords.
+            uInt Hashes[count];
+            // Table mapping slots to keyword indices. Empty slots contain -1.
+            Int Table[Capacity];
+            // Odd multiplier used to scatter the hashes across the table without collisions.
+            uInt Seed;
+
+        public:
+            // Constructors
+
+            // Keyword list constructor. Searches for a seed that places every keyword into its own slot.
+            constexpr Perfect(const char* const(&keywords)[count]) : Keywords(), Lengths(), Hashes(), Table(), Seed(1)
+            {
+                // Hash every keyword.
+                for(Int i = 0; i < count; i++)
+                {
+                    // Starting hash offset basis.
+                    uInt hash = 2166136261;
+                    Int length = 0;
+                    // -- //
+                    for(; keywords[i][length]; length++)
+                    {
+                        // Same as the FNV32 functions above, inlined here since they can't be evaluated on a plain pointer at compile-time.
+                        hash = (hash ^ Byte(keywords[i][length])) * 16777619;
+                    }
+
+                    // Store the keyword.
+                    Keywords[i] = keywords[i];
+                    Lengths[i] = length;
+                    Hashes[i] = hash;
+
+                    // Compile-time check; Two keywords can never be told apart if their hashes are equal.
+                    for(Int j = 0; j < i; j++)
+                    {
+                        Assert(Hashes[j] != hash, "Cannot build the perfect hash table. Two keywords share the same hash.");
+                    }
+                }
+
+                // Try seeds until one is found that doesn't collide any of the keywords.
+                for(; Seed < (1u << 20); Seed += 2)
+                {
+                    // Clear the table.
+                    for(Int i = 0; i < Capacity; i++) { Table[i] = -1; }
+
+                    Int i = 0;
+                    // Place the keywords until one lands in an occupied slot.
+                    for(; i < count; i++)
+                    {
+                        // Compute the keyword's slot.
+                        uInt slot = Slot(Hashes[i]);
+                        // -- //
+                        if(Table[slot] >= 0) { break; }
+                        // -- //
+                        Table[slot] = i;
+                    }
+
+                    // Every keyword was placed, the seed is perfect.
+                    if(i == count) { return; }
+                }
+
+                // Compile-time check
+                Assert(false, "Cannot build the perfect hash table. No collision-free seed was found.");
+            };
+
+            // Methods
+
+            // Compute the slot a hash maps to.
+            constexpr uInt Slot(uInt hash) const
+            {
+                // Multiplicative hashing; The upper bits of the product are the best mixed.
+                return (hash * Seed) >> (32 - Bits);
+            };
+
+            // Lookup a keyword using its hash and return its index. Returns -1 if the hash doesn't belong to a keyword.
+            constexpr Int Find(uInt hash) const
+            {
+                // Probe the table once and confirm the hash matches.
+                Int index = Table[Slot(hash)];
+                // -- //
+                return ((index >= 0) && (Hashes[index] == hash)) ? index : -1;
+            };
+
+            // Lookup a keyword and return its index. Returns -1 if the string isn't a keyword.
+            // Unlike the hash-only lookup, the characters are compared too, so a foreign string can never be mistaken for a keyword.
+            Int Find(const Byte* string, Int length) const
+            {
+                // Probe the table using the string's hash.
+                Int index = Find(FNV32(string, length));
+
+                // Confirm the characters match.
+                if(index >= 0)
+                {
+                    // A differing length or character means the hash collided with a keyword.
+                    if(Lengths[index] != length) { return -1; }
+                    // -- //
+                    for(Int i = 0; i < length; i++)
+                    {
+                        if(Keywords[index][i] != string[i]) { return -1; }
+                    }
+                }
+                // -- //
+                return index;
+            };
+
+            // Retrieve the index of a keyword during compile-time. Fails to compile if the string isn't a keyword.
+            template <size_t size> constexpr Int Index(const char(&string)[size]) const
+            {
+                // Lookup the keyword.
+                Int index = Find(FNV32(string));
+
+                // Compile-time check
+                Assert(index >= 0, "The string isn't a keyword contained in the perfect hash table.");
+                // -- //
+                return index;
+            };
+        };
     }
 }
@@ -11,6 +11,8 @@
 #include "..\Common\Hash.hpp"
 #include "..\Common\Memory.hpp"
 #include "..\Common\Set.hpp"
+// Namespace pollution (required for prefetch intrinsics).
+#include <xmmintrin.h>
 
 // TODO: Refactor Map as it has been lazily imported without change.
 
@@ -56,7 +58,7 @@ namespace R2D
                 if(index < 0)
                 {
                     // Attempt to locate the next bucket that contains entries.
-                    Int bucket = BitSet(~(Handle->Index.Mask) | ((2ULL << (Index >> 6)) - 1)).Query();
+                    Int bucket = Handle->Occupied((Index >> 6) + 1);
 
                     // If there aren't anymore buckets with active entries..
                     if(bucket < 0)
@@ -93,8 +95,8 @@ namespace R2D
         Key* Keys;
         // Array of buckets describing groups of entries in the map.
         Bucket* Buckets;
-        // Index denoting which buckets contain active entries.
-        BitSet Index;
+        // Array of bitsets denoting which buckets contain active entries, with one bitset for every 64 buckets.
+        BitSet* Index;
         // Number of entries contained in the map.
         Int Count;
         // Maximum number of entries the map can contain.
@@ -104,11 +106,11 @@ namespace R2D
         // Constructors
 
         // Default constructor.
-        Map() : Data(nullptr), Keys(nullptr), Buckets(nullptr), Index(), Count(0), Capacity(0) {};
+        Map() : Data(nullptr), Keys(nullptr), Buckets(nullptr), Index(nullptr), Count(0), Capacity(0) {};
         // Copy constructor.
         Map(const Map& other) = delete;
         // Move constructor.
-        Map(Map&& other) : Data(other.Data), Keys(other.Keys), Buckets(other.Buckets), Index(R2D::Move(other.Index)), Count(other.Count), Capacity(other.Capacity) { other.Data = nullptr; other.Keys = nullptr; other.Buckets = nullptr; other.Count = 0; other.Capacity = 0; };
+        Map(Map&& other) : Data(other.Data), Keys(other.Keys), Buckets(other.Buckets), Index(other.Index), Count(other.Count), Capacity(other.Capacity) { other.Data = nullptr; other.Keys = nullptr; other.Buckets = nullptr; other.Index = nullptr; other.Count = 0; other.Capacity = 0; };
         // Destructor.
         ~Map() { Release(); };
 
@@ -130,19 +132,24 @@ namespace R2D
             // Debug check
             Assert(POPCNT(Capacity) == 1, "Cannot create maps whose capacities aren't a power of 2.");
 
-            Int size[3];
-            // Compute the size of the new buffer as a combination of the three data arrays.
+            // Allocate one bucket for every 64 entries, and one bitset of the index for every 64 buckets.
+            Int buckets = ((Capacity - 1) / 64) + 1;
+            Int words = ((buckets - 1) / 64) + 1;
+
+            Int size[4];
+            // Compute the size of the new buffer as a combination of the four data arrays.
             size[0] = sizeof(Value) * Capacity;
             size[1] = sizeof(Key) * Capacity;
-            size[2] = sizeof(Bucket) * (((Capacity - 1) / 64) + 1);
-            // Allocate one bucket for every 64 entries.
+            size[2] = sizeof(Bucket) * buckets;
+            size[3] = sizeof(BitSet) * words;
 
             // Request the new memory and assign the pointers.
-            Byte* memory = (Byte*)Memory::Resize(Data, size[0] + size[1] + size[2]);
+            Byte* memory = (Byte*)Memory::Resize(Data, size[0] + size[1] + size[2] + size[3]);
             // -- //
             Data = (Value*)(memory);
             Keys = (Key*)(memory + size[0]);
             Buckets = (Bucket*)(memory + size[0] + size[1]);
+            Index = (BitSet*)(memory + size[0] + size[1] + size[2]);
 
             // Construct all of the Value objects.
             for(Int i = 0; i < Capacity; i++)
@@ -157,11 +164,13 @@ namespace R2D
                 new(Keys + i)Key();
             }
             // Construct all of the Bucket objects.
-            for(Int i = 0; i < (((Capacity - 1) / 64) + 1); i++)
+            for(Int i = 0; i < buckets; i++)
             {
                 // Call the default constructor.
                 new(Buckets + i)Bucket();
             }
+            // Construct the index.
+            for(Int i = 0; i < words; i++) { new(Index + i)BitSet(); }
 
             // Iterate through the old map and add all of its entries to this new map.
             for(auto iterator = old.First(); !iterator.Last(); iterator.Next())
@@ -184,6 +193,7 @@ namespace R2D
             // -- //
             Keys = nullptr;
             Buckets = nullptr;
+            Index = nullptr;
             Count = 0;
             Capacity = 0;
         };
@@ -198,7 +208,7 @@ namespace R2D
             if(Count)
             {
                 // Locate the first entry's index and start the iterator there.
-                Int bucket = BitSet(~Index.Mask).Query();
+                Int bucket = Occupied(0);
                 iterator.Index = (bucket * 64) + BitSet(~Buckets[bucket].Active.Mask).Query();
                 return iterator;
             }
@@ -218,6 +228,24 @@ namespace R2D
             iterator.Index = Capacity;
         };
 
+        // Retrieve the index of the first bucket at or after the specified one that contains entries, or -1 if there are none.
+        Int Occupied(Int bucket) const
+        {
+            // Helper
+            Int buckets = ((Capacity - 1) / 64) + 1;
+
+            // Scan the index, skipping the buckets before the specified one in its bitset.
+            for(Int word = bucket >> 6; (word << 6) < buckets; word++)
+            {
+                uLong mask = Index[word].Mask;
+                // -- //
+                if(word == (bucket >> 6)) { mask &= ~0ULL << (bucket & 63); }
+                if(mask) { return (word << 6) + BitScanForward(mask); }
+            }
+            // -- //
+            return -1;
+        };
+
         // Compute the health of the map, as in the percentage of entries that aren't collided.
         Float Health() const;
         // Heal the map, potentially reducing the number of collided entries by cleaning up collided slots that lead to nowhere and placing collided entries closer to their true (uncollided) slot.
@@ -248,7 +276,7 @@ namespace R2D
             Int bucket = slot >> 6;
 
             // Linear probing only needs to be done if the bucket isn't empty.
-            if(Index.Get(bucket))
+            if(Index[bucket >> 6].Get(bucket & 63))
             {
                 // If the current slot already contains an active entry..
                 while(Buckets[bucket].Active.Get(slot & 63))
@@ -260,7 +288,8 @@ namespace R2D
                     Buckets[bucket].Collided.Set(slot & 63);
 
                     // Move to the next slot and update the indexes;
-                    bucket = (++slot & (Capacity - 1)) >> 6;
+                    slot = (slot + 1) & (Capacity - 1);
+                    bucket = slot >> 6;
                 }
             }
 
@@ -268,7 +297,7 @@ namespace R2D
             Count++;
 
             // Flag the bucket as containing entries.
-            Index.Set(bucket);
+            Index[bucket >> 6].Set(bucket & 63);
             // Flag the entry in the bucket as active.
             Buckets[bucket].Active.Set(slot & 63);
 
@@ -287,8 +316,61 @@ namespace R2D
             // Return if the map isn't allocated yet.
             if(!Data) { return nullptr; }
 
-            // Mask the hashed key to compute the slot index and bucket index.
-            Int slot = Hash::FNV32(key) & (Capacity - 1);
+            // Mask the hashed key to compute the slot index and probe from there.
+            return Probe(key, Hash::FNV32(key) & (Capacity - 1));
+        };
+
+        // Lookup a batch of entries, writing a pointer to each one's payload (or nullptr if it wasn't found) to the output array.
+        // In tables larger than a few MiB, the keys are hashed and their buckets prefetched a few lookups ahead of being probed, so the
+        // cache misses of consecutive lookups overlap instead of being paid one after another as when calling Find() in a loop.
+        Void FindMany(const Key* keys, Int count, Value** output) const
+        {
+            // Nothing can be found if the map isn't allocated yet.
+            if(!Data)
+            {
+                for(Int i = 0; i < count; i++) { output[i] = nullptr; }
+                return;
+            }
+
+            // Tables that fit in the caches gain little from prefetching, and the extra work of the pipeline can make the batch slower
+            // than plain lookups (0.89-1.15x at 0.8-3 MiB depending on the machine, against 1.2-1.6x at 12 MiB and 1.7-1.9x from
+            // 48 MiB up, see MapBench), so those just probe one key after another.
+            if(Long(Capacity) * (sizeof(Key) + sizeof(Value)) < (Long(1) << 22))
+            {
+                for(Int i = 0; i < count; i++) { output[i] = Probe(keys[i], Hash::FNV32(keys[i]) & (Capacity - 1)); }
+                return;
+            }
+
+            // How many lookups ahead the keys are hashed and prefetched. Must be a power of two.
+            constexpr Int Distance = 8;
+            // Ring of the precomputed slots of the lookups in flight.
+            Int slots[Distance];
+
+            // Run the hashing stage Distance lookups ahead of the probing stage. Probing first frees up the ring slot the next key is hashed into.
+            for(Int i = 0; i < (count + Distance); i++)
+            {
+                // Probe the key that was prefetched Distance lookups ago.
+                Int j = i - Distance;
+                // -- //
+                if(j >= 0) { output[j] = Probe(keys[j], slots[j & (Distance - 1)]); }
+
+                // Hash the next key and prefetch the memory its probe will start on.
+                if(i < count)
+                {
+                    Int slot = Hash::FNV32(keys[i]) & (Capacity - 1);
+                    // -- //
+                    _mm_prefetch((const char*)(Buckets + (slot >> 6)), _MM_HINT_T0);
+                    _mm_prefetch((const char*)(Keys + slot), _MM_HINT_T0);
+                    slots[i & (Distance - 1)] = slot;
+                }
+            }
+        };
+
+        // Lookup an entry by linearly probing from the specified slot, which should be the slot the key hashes to.
+        // Used internally by Find() and FindMany().
+        Value* Probe(const Key& key, Int slot) const
+        {
+            // Compute the bucket index.
             Int bucket = slot >> 6;
 
             // Loop through (potentially) every entry in the map.
@@ -313,7 +395,8 @@ namespace R2D
                 }
 
                 // Move to the next entry.
-                bucket = (++slot & (Capacity - 1)) >> 6;
+                slot = (slot + 1) & (Capacity - 1);
+                bucket = slot >> 6;
             }
 
             // No entry with a matching key was found.
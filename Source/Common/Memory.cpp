@@ -118,4 +118,23 @@ namespace R2D
         // Internally just a helper for calling Memory::Set(). Could potentially be more efficient than Set, however.
         Memory::Set(destination, 0, size);
     };
+
+    // ----------------------------------------------------------------------------------------
+    Bool Memory::Compare(const Void* first, const Void* second, Long size)
+    {
+        // Debug check
+        Assert(size >= 0, "Attempting to compare an invalid amount of memory.");
+
+        // Only compare memory if size is larger than zero.
+        if(size > 0)
+        {
+            // Debug checks
+            Assert(first && second, "Attempting to compare an invalid memory buffer.");
+
+            // Simply call memcmp
+            return memcmp(first, second, size) == 0;
+        }
+        // -- //
+        return true;
+    };
 }
@@ -58,5 +58,9 @@ namespace R2D
 
         // Initialize a block of memory to zero. Helper function for calling Memory::Set().
         extern Void Zero(Void* destination, Long size);
+
+        // Compare two blocks of memory. Returns true if their contents are equal. Always true if a size of zero bytes is specified.
+        // Does not fail silently if either pointer is null or the size is negative.
+        extern Bool Compare(const Void* first, const Void* second, Long size);
     }
 }
@@ -21,13 +21,15 @@ namespace R2D
         // Allocate the requested amount of memory.
         Data = (Byte*)Memory::Request(size);
         Size = size;
+        Owner = true;
     };
 
     // ----------------------------------------------------------------------------------------
     Void Memory::Buffer::Release()
     {
-        // Deallocate the memory.
-        if(Data) { Memory::Free(Data); Data = nullptr; }
+        // Deallocate the memory, unless it's only being viewed.
+        if(Data && Owner) { Memory::Free(Data); }
+        Data = nullptr;
         // Reset the members.
         Position = 0;
         Size = 0;
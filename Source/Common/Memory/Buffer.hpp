@@ -38,18 +38,20 @@ namespace R2D
             Long Position;
             // The size of the buffer's data in bytes.
             Long Size;
+            // Whether the buffer owns its data and frees it on release. Buffers viewing memory owned elsewhere (like a mapped file) don't.
+            Bool Owner;
 
         public:
             // Constructors
 
             // Default constructor.
-            Buffer() : Data(nullptr), Position(0), Size(0) {};
-            // Data and Size constructor.
-            Buffer(Void* buffer, Long size) : Data((Byte*)buffer), Position(0), Size(size) {};
+            Buffer() : Data(nullptr), Position(0), Size(0), Owner(true) {};
+            // Data and Size constructor. Takes ownership of the data unless owner is false, in which case the data must outlive the buffer.
+            Buffer(Void* buffer, Long size, Bool owner = true) : Data((Byte*)buffer), Position(0), Size(size), Owner(owner) {};
             // Copy constructor.
             Buffer(const Buffer& other) = delete;
             // Move constructor.
-            Buffer(Buffer&& other) : Data(other.Data), Position(other.Position), Size(other.Size) { other.Data = nullptr; other.Position = 0; other.Size = 0; };
+            Buffer(Buffer&& other) : Data(other.Data), Position(other.Position), Size(other.Size), Owner(other.Owner) { other.Data = nullptr; other.Position = 0; other.Size = 0; };
             // Destructor.
             ~Buffer() { Release(); };
 
@@ -0,0 +1,198 @@
+/*
+-------------------------------------------------------------------------------
+    Filename: Common/Memory/Epoch.cpp
+-------------------------------------------------------------------------------
+*/
+
+// Includes
+#include "..\..\Common\Memory\Epoch.hpp"
+// -- //
+#include "..\..\Common\Array.hpp"
+#include "..\..\Common\Memory.hpp"
+// -- //
+#include <atomic>
+#include <mutex>
+
+// --------------------------------------------------------------------------------------------
+namespace R2D
+{
+    // Per-thread epoch record. Padded to a cache line so threads don't contend over each other's records.
+    struct alignas(64) EpochRecord
+    {
+        // The epoch the thread observed when it entered its critical section. Zero while the thread is outside of one.
+        std::atomic<uLong> Epoch = 0;
+        // Flag denoting the record has been claimed by a thread.
+        std::atomic<Bool> Owned = false;
+    };
+
+    // Thread-local handle to the calling thread's epoch record.
+    struct EpochLocal
+    {
+        // Index of the record claimed by the thread, or -1 if the thread hasn't claimed one yet.
+        Int Index = -1;
+        // The number of nested guards the thread is currently inside of.
+        Int Depth = 0;
+        // The number of critical sections the thread has left, for collecting every so often.
+        uInt Leaves = 0;
+
+        // Destructor. Hands the record back once the thread exits.
+        ~EpochLocal();
+    };
+
+    // An allocation waiting to be released.
+    struct EpochRetired
+    {
+        // The retired allocation.
+        Void* Pointer;
+        // The function releasing the allocation.
+        Memory::Epoch::Release Release;
+        // The global epoch at the time the allocation was retired.
+        uLong Epoch;
+    };
+
+    // The global epoch. Starts at one since zero denotes an inactive record.
+    static std::atomic<uLong> epochGlobal = 1;
+    // The global epoch the retired allocations were last scanned at. Nothing new can be released until the epoch advances past it.
+    static uLong epochScanned = 0;
+    // The records of every thread that has entered a critical section.
+    static EpochRecord epochRecords[Memory::Epoch::Threads];
+    // The calling thread's record handle.
+    static thread_local EpochLocal epochLocal;
+    // The number of threads inside a critical section without a record, because every record was claimed. What epoch they observed
+    // isn't known, so the epoch can't advance while there are any.
+    static std::atomic<Int> epochOverflow = 0;
+    // The number of retired allocations waiting to be released, read without taking the lock.
+    static std::atomic<Int> epochPending = 0;
+    // Allocations waiting to be released, and the lock protecting them. Retiring is rare compared to reading, so a lock is fine here.
+    static Array<EpochRetired> epochRetired;
+    static std::mutex epochMutex;
+
+    // ----------------------------------------------------------------------------------------
+    EpochLocal::~EpochLocal()
+    {
+        // Release the record for reuse by another thread.
+        if(Index >= 0) { epochRecords[Index].Epoch.store(0); epochRecords[Index].Owned.store(false); }
+    };
+
+    // ----------------------------------------------------------------------------------------
+    Void Memory::Epoch::Enter()
+    {
+        // Only the outermost guard publishes the epoch.
+        if(epochLocal.Depth++ > 0) { return; }
+
+        // Claim a record the first time the thread enters a critical section.
+        if(epochLocal.Index < 0)
+        {
+            for(Int i = 0; i < Threads; i++)
+            {
+                Bool owned = false;
+                // Attempt to take ownership of the record.
+                if(epochRecords[i].Owned.compare_exchange_strong(owned, true)) { epochLocal.Index = i; break; }
+            }
+
+            // Without a free record, the thread holds back the epoch as a whole until it leaves. The fence keeps the following reads
+            // from being reordered before the count is raised. It tries again for a record the next time it enters.
+            if(epochLocal.Index < 0)
+            {
+                epochOverflow.fetch_add(1);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                return;
+            }
+        }
+
+        // Publish the observed epoch. The fence keeps the following reads from being reordered before the store.
+        epochRecords[epochLocal.Index].Epoch.store(epochGlobal.load());
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+    };
+
+    // ----------------------------------------------------------------------------------------
+    Void Memory::Epoch::Leave()
+    {
+        // Debug check
+        Assert(epochLocal.Depth > 0, "Attempting to leave a critical section that was never entered.");
+
+        // Only the outermost guard clears the epoch.
+        if(--epochLocal.Depth == 0)
+        {
+            if(epochLocal.Index >= 0) { epochRecords[epochLocal.Index].Epoch.store(0, std::memory_order_release); }
+            else { epochOverflow.fetch_sub(1, std::memory_order_release); }
+
+            // Collect every so often while allocations are waiting, so the last ones retired are released even if nothing is retired after them.
+            if(epochPending.load(std::memory_order_relaxed) && !(++epochLocal.Leaves & 63)) { Collect(); }
+        }
+    };
+
+    // ----------------------------------------------------------------------------------------
+    Void Memory::Epoch::Retire(Void* pointer, Release release)
+    {
+        {
+            std::lock_guard<std::mutex> lock(epochMutex);
+            // Queue the allocation, tagged with the current epoch.
+            if(epochRetired.Count == epochRetired.Capacity) { epochRetired.Reserve(epochRetired.Capacity ? epochRetired.Capacity : 64); }
+            // -- //
+            epochRetired.Append(EpochRetired{ pointer, release, epochGlobal.load() });
+            epochPending.store(epochRetired.Count, std::memory_order_relaxed);
+        }
+
+        // Opportunistically release whatever is safe to release.
+        Collect();
+    };
+
+    // ----------------------------------------------------------------------------------------
+    Void Memory::Epoch::Collect()
+    {
+        std::lock_guard<std::mutex> lock(epochMutex);
+
+        // The epoch can only advance once every active thread has observed the current one.
+        uLong epoch = epochGlobal.load();
+        Bool advance = !epochOverflow.load();
+        // -- //
+        for(Int i = 0; i < Threads; i++)
+        {
+            uLong local = epochRecords[i].Epoch.load();
+            // -- //
+            if(local && (local != epoch)) { advance = false; break; }
+        }
+        // -- //
+        if(advance) { epochGlobal.compare_exchange_strong(epoch, epoch + 1); epoch = epochGlobal.load(); }
+
+        // Skip the scan if the epoch hasn't moved since the last one. A thread stalled inside its critical section holds the epoch back,
+        // and rescanning the growing list on every retirement until it leaves would make each retirement linear in the list's size.
+        if(epoch == epochScanned) { return; }
+        // -- //
+        epochScanned = epoch;
+
+        // An allocation retired during epoch N can't be referenced anymore once the global epoch reaches N + 2,
+        // since every active thread has entered its critical section after the allocation was unlinked.
+        for(Int i = 0; i < epochRetired.Count;)
+        {
+            if(epochRetired[i].Epoch + 2 <= epoch)
+            {
+                // Release the allocation and fill its slot with the last entry.
+                epochRetired[i].Release(epochRetired[i].Pointer);
+                epochRetired[i] = epochRetired[--epochRetired.Count];
+            }
+            else
+            {
+                i++;
+            }
+        }
+        // -- //
+        epochPending.store(epochRetired.Count, std::memory_order_relaxed);
+    };
+
+    // ----------------------------------------------------------------------------------------
+    Void Memory::Epoch::Flush()
+    {
+        std::lock_guard<std::mutex> lock(epochMutex);
+
+        // Release every retired allocation.
+        for(Int i = 0; i < epochRetired.Count; i++)
+        {
+            epochRetired[i].Release(epochRetired[i].Pointer);
+        }
+        // -- //
+        epochRetired.Release();
+        epochPending.store(0, std::memory_order_relaxed);
+    };
+}
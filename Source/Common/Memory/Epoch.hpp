@@ -0,0 +1,71 @@
+/*
+-------------------------------------------------------------------------------
+    Filename: Common/Memory/Epoch.hpp
+-------------------------------------------------------------------------------
+*/
+
+// Header guard
+#pragma once
+// Includes
+#include "..\..\Common.hpp"
+
+// --------------------------------------------------------------------------------------------
+namespace R2D
+{
+    // ----------------------------------------------------------------------------------------
+    namespace Memory
+    {
+        // ------------------------------------------------------------------------------------
+        // Epoch-based memory reclamation for lock-free containers.
+        // Readers wrap their accesses in a Guard. Memory unlinked from a shared structure is handed to Retire() rather than
+        // being freed directly, and is only released once every thread that could still be reading it has left its guard.
+        class Epoch
+        {
+        public:
+            // Types
+
+            // Function used to destroy and free a retired allocation.
+            typedef Void(*Release)(Void* pointer);
+
+            // Scoped helper for entering and leaving the critical section. Guards can be nested.
+            class Guard
+            {
+            public:
+                // Constructors
+
+                // Default constructor. Enters the critical section.
+                Guard() { Epoch::Enter(); };
+                // Copy constructor.
+                Guard(const Guard& other) = delete;
+                // Move constructor.
+                Guard(Guard&& other) = delete;
+                // Destructor. Leaves the critical section.
+                ~Guard() { Epoch::Leave(); };
+            };
+
+        public:
+            // Constants
+
+            // The number of threads that can have records of their own. Threads beyond that still work, but hold back the release of
+            // retired allocations while they're inside a critical section.
+            static constexpr Int Threads = 128;
+
+        public:
+            // Methods
+
+            // Static; Enter the critical section on the calling thread. Pointers read from shared structures stay valid until Leave() is called.
+            static Void Enter();
+            // Static; Leave the critical section on the calling thread.
+            static Void Leave();
+
+            // Static; Queue an allocation to be released once no thread can still be referencing it.
+            // The allocation must already be unreachable from the shared structure it was removed from.
+            static Void Retire(Void* pointer, Release release);
+            // Static; Attempt to advance the global epoch and release the retired allocations that are no longer referenced.
+            // Called by Retire(), and every so often by Leave() while allocations are waiting.
+            static Void Collect();
+            // Static; Release every retired allocation regardless of epoch. Only valid when no thread is inside a critical section.
+            static Void Flush();
+        };
+    }
+}
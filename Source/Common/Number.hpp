@@ -0,0 +1,51 @@
+/*
+-------------------------------------------------------------------------------
+    Filename: Common/Number.hpp
+-------------------------------------------------------------------------------
+*/
+
+// Header guard
+#pragma once
+// Includes
+#include "..\Common.hpp"
+#include "..\Common\StringView.hpp"
+
+// --------------------------------------------------------------------------------------------
+namespace R2D
+{
+    // ----------------------------------------------------------------------------------------
+    // Conversions between numbers and text that never allocate.
+    // The parse functions read a number from the start of the text and return the number of characters consumed,
+    // or zero if the text doesn't start with a valid number (or it doesn't fit in the output type), in which case the output is left untouched.
+    // The format functions write the number into a caller-provided buffer of at least Number::Capacity bytes, without a null-byte,
+    // and return the number of characters written.
+    namespace Number
+    {
+        // The buffer size that's large enough for any formatted number.
+        constexpr Int Capacity = 32;
+
+        // Parse a signed decimal integer, with an optional sign.
+        extern Int Parse(const StringView& text, Long& value);
+        // Parse an unsigned decimal integer.
+        extern Int Parse(const StringView& text, uLong& value);
+        // Parse an unsigned hexadecimal integer, with an optional 0x prefix.
+        extern Int ParseHex(const StringView& text, uLong& value);
+        // Parse a decimal floating-point number, with an optional sign, fraction and exponent. The result is correctly rounded.
+        // Numbers that round to infinity don't fit, while numbers too small for the type round to zero.
+        extern Int Parse(const StringView& text, Double& value);
+        // Parse a decimal floating-point number, with an optional sign, fraction and exponent. The result is correctly rounded.
+        // Numbers that round to infinity don't fit, while numbers too small for the type round to zero.
+        extern Int Parse(const StringView& text, Float& value);
+
+        // Format a signed integer in decimal.
+        extern Int Format(Long value, Byte* buffer);
+        // Format an unsigned integer in decimal.
+        extern Int Format(uLong value, Byte* buffer);
+        // Format an unsigned integer in hexadecimal (uppercase, without a prefix).
+        extern Int FormatHex(uLong value, Byte* buffer);
+        // Format a floating-point number using the fewest digits that parse back to the same value.
+        extern Int Format(Double value, Byte* buffer);
+        // Format a floating-point number using the fewest digits that parse back to the same value.
+        extern Int Format(Float value, Byte* buffer);
+    }
+}
@@ -0,0 +1,202 @@
+/*
+-------------------------------------------------------------------------------
+    Filename: Common/PagedArray.hpp
+-------------------------------------------------------------------------------
+*/
+
+// Header guard
+#pragma once
+// Includes
+#include "..\Common.hpp"
+#include "..\Common\Memory.hpp"
+
+// --------------------------------------------------------------------------------------------
+namespace R2D
+{
+    // ----------------------------------------------------------------------------------------
+    // Array whose entries never move. Entries are stored in fixed-size pages of 2^Bits entries, found through a table of pages,
+    // so indexing is a shift and a mask, and growing only allocates new pages (and occasionally a larger page table) without copying
+    // any entries. Pointers and references to entries stay valid until the array is released, which makes it suitable for storage
+    // that other objects point into. Entries within a page are contiguous, but pages aren't contiguous with each other.
+    template <typename Type, Int Bits = 10> class PagedArray
+    {
+    public:
+        // Constants
+
+        // The number of entries in a page.
+        static constexpr Int Page = 1 << Bits;
+
+        // Types
+
+        // Helper object for iterating through the entries with a foreach loop.
+        class Iterator
+        {
+        public:
+            // Members
+
+            // Handle to the array being iterated.
+            const PagedArray* Handle;
+            // The index of the current entry.
+            Int Index;
+
+            // Operators
+
+            // Access the current entry.
+            Type& operator * () const { return Handle->Pages[Index >> Bits][Index & (Page - 1)]; };
+            // Advance to the next entry.
+            Iterator& operator ++ () { Index++; return *this; };
+            // Check if two iterators are at different entries.
+            Bool operator != (const Iterator& other) const { return Index != other.Index; };
+        };
+
+    public:
+        // Members
+
+        // Table of handles to the pages.
+        Type** Pages;
+        // The number of active entries currently in the array.
+        Int Count;
+        // The number of pages allocated.
+        Int PageCount;
+        // The number of handles the page table can hold.
+        Int TableCapacity;
+
+    public:
+        // Constructors
+
+        // Default constructor.
+        PagedArray() : Pages(nullptr), Count(0), PageCount(0), TableCapacity(0) {};
+        // Copy constructor.
+        PagedArray(const PagedArray& other) = delete;
+        // Move constructor.
+        PagedArray(PagedArray&& other) : Pages(other.Pages), Count(other.Count), PageCount(other.PageCount), TableCapacity(other.TableCapacity)
+        {
+            other.Pages = nullptr; other.Count = 0; other.PageCount = 0; other.TableCapacity = 0;
+        };
+        // Destructor
+        ~PagedArray() { Release(); };
+
+        // Operators
+
+        // Move assignment operator. Releases the current pages before assimilating the other array.
+        PagedArray& operator = (PagedArray&& other)
+        {
+            // Release the existing memory.
+            Release();
+
+            // Assimilate the other array.
+            Pages = other.Pages; Count = other.Count; PageCount = other.PageCount; TableCapacity = other.TableCapacity;
+            other.Pages = nullptr; other.Count = 0; other.PageCount = 0; other.TableCapacity = 0;
+
+            return *this;
+        };
+
+        // Array access operator.
+        Type& operator [] (Int index)
+        {
+            // Debug checks
+            Assert(index >= 0, "Tried to access an element with a negative index.");
+            Assert(index < Capacity(), "Tried to access an element past the end of the array.");
+
+            return Pages[index >> Bits][index & (Page - 1)];
+        };
+        // Const array access operator.
+        const Type& operator [] (Int index) const
+        {
+            // Debug checks
+            Assert(index >= 0, "Tried to access an element with a negative index.");
+            Assert(index < Capacity(), "Tried to access an element past the end of the array.");
+
+            return Pages[index >> Bits][index & (Page - 1)];
+        };
+
+        // Methods
+
+        // foreach loop begin hook.
+        Iterator begin() const
+        {
+            return Iterator{ this, 0 };
+        };
+        // foreach loop end hook.
+        Iterator end() const
+        {
+            return Iterator{ this, Count };
+        };
+
+        // The maximum number of entries that can be contained in the allocated pages.
+        Int Capacity() const
+        {
+            return PageCount << Bits;
+        };
+
+        // Allocate pages until there's room for count more entries. Existing entries aren't moved.
+        // The new entries are created in an uninitialized state and need to be constructed.
+        Void Reserve(Int count)
+        {
+            // Debug check
+            Assert(count >= 0, "Attempting to increase the capacity of the array by a negative amount.");
+
+            // Helper
+            Int pages = (Count + count + Page - 1) >> Bits;
+
+            // Grow the page table geometrically. Only the handles are copied, never the entries.
+            if(pages > TableCapacity)
+            {
+                Int capacity = TableCapacity ? TableCapacity * 2 : 8;
+                // -- //
+                if(capacity < pages) { capacity = pages; }
+                Pages = (Type**)Memory::Resize(Pages, sizeof(Type*) * capacity);
+                TableCapacity = capacity;
+            }
+
+            // Allocate the missing pages.
+            for(; PageCount < pages; PageCount++)
+            {
+                Pages[PageCount] = (Type*)Memory::Request(sizeof(Type) * Page, (alignof(Type) > 16) ? alignof(Type) : 16);
+            }
+        };
+
+        // Append count default constructed entries. Obeys the same rules as Reserve().
+        Void Expand(Int count)
+        {
+            // Make room for and construct the new entries.
+            Reserve(count);
+            // -- //
+            for(Int i = 0; i < count; i++)
+            {
+                new(&(*this)[Count + i])Type();
+            }
+
+            // Update the count
+            Count += count;
+        };
+
+        // Construct an entry in-place at the end of the array, allocating a new page if the last one is full. Returns its index.
+        template <typename... Arguments> Int Append(Arguments&&... arguments)
+        {
+            // Allocate another page if needed.
+            if(Count == Capacity()) { Reserve(1); }
+
+            // Retrieve a slot index at the end of the array.
+            Int slot = Count++;
+
+            // Construct the object in-place.
+            new(&(*this)[slot])Type(arguments...);
+
+            // Return the slot index.
+            return slot;
+        };
+
+        // Releases the pages and the page table. Does not destruct the entries contained in the array.
+        Void Release()
+        {
+            // Deallocate the memory.
+            for(Int i = 0; i < PageCount; i++) { Memory::Free(Pages[i]); }
+            if(Pages) { Memory::Free(Pages); Pages = nullptr; }
+            // Reset the members.
+            Count = 0;
+            PageCount = 0;
+            TableCapacity = 0;
+        };
+    };
+}
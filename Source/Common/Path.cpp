@@ -0,0 +1,199 @@
+/*
+-------------------------------------------------------------------------------
+    Filename: Common/Path.cpp
+-------------------------------------------------------------------------------
+*/
+
+// Includes
+#include "..\Common\Path.hpp"
+
+// --------------------------------------------------------------------------------------------
+namespace R2D
+{
+    // ----------------------------------------------------------------------------------------
+    // Returns 1 for a separator, 2 for a drive without a separator (which is treated as the drive's root), 3 for a drive with a separator
+    // and 0 for a relative path.
+    Int Path::Root(const StringView& path)
+    {
+        // Helper
+        Int length = path.Length();
+
+        // A leading separator of either kind.
+        if(length && ((path[0] == '/') || (path[0] == '\\'))) { return 1; }
+
+        // A drive letter followed by a colon.
+        if((length >= 2) && (((path[0] | 32) >= 'a') && ((path[0] | 32) <= 'z')) && (path[1] == ':'))
+        {
+            return ((length >= 3) && ((path[2] == '/') || (path[2] == '\\'))) ? 3 : 2;
+        }
+        // -- //
+        return 0;
+    };
+
+    // ----------------------------------------------------------------------------------------
+    Int Path::Root() const
+    {
+        // Normalized drives always include their separator.
+        return Root(Buffer);
+    };
+
+    // ----------------------------------------------------------------------------------------
+    StringView Path::Parent() const
+    {
+        // Helpers
+        Int root = Root();
+        Int length = Length();
+
+        // The root and the empty path are their own parents.
+        if(length <= root) { return View(); }
+
+        // Cut the path at the last separator, keeping the root.
+        Int separator = Buffer.rFind(Separator);
+        // -- //
+        return View().Slice(0, (separator < root) ? root : separator);
+    };
+
+    // ----------------------------------------------------------------------------------------
+    StringView Path::Name() const
+    {
+        // Helpers
+        Int root = Root();
+        Int length = Length();
+
+        // The root doesn't have a name.
+        if(length <= root) { return StringView(); }
+
+        // The name follows the last separator (or the root).
+        Int separator = Buffer.rFind(Separator);
+        Int start = (separator < root) ? root : separator + 1;
+        // -- //
+        return View().Slice(start, length - start);
+    };
+
+    // ----------------------------------------------------------------------------------------
+    StringView Path::Stem() const
+    {
+        // Helpers
+        StringView name = Name();
+        Int period = name.Length() ? name.rFind('.') : -1;
+
+        // Cut the name at the extension's period, unless it's the first character or the name is a parent directory component.
+        return ((period > 0) && (name != "..")) ? name.Slice(0, period) : name;
+    };
+
+    // ----------------------------------------------------------------------------------------
+    StringView Path::Extension() const
+    {
+        // Helpers
+        StringView name = Name();
+        Int period = name.Length() ? name.rFind('.') : -1;
+
+        // The extension follows the last period, unless it's the first character or the name is a parent directory component.
+        return ((period > 0) && (name != "..")) ? name.Slice(period + 1, name.Length()) : StringView();
+    };
+
+    // ----------------------------------------------------------------------------------------
+    Path& Path::Join(const StringView& path)
+    {
+        // A view of the path's own characters would be read while they're overwritten, or after growing moved them, so join a copy instead.
+        if((path.Data() >= Buffer.Data()) && (path.Data() < Buffer.Data() + Length())) { return Join(String(path)); }
+
+        // Helpers
+        Int root = Root(path);
+        Int length = root ? 0 : Length();
+        Int hashed = length;
+        Bool rehash = (root > 0);
+
+        // An absolute path rewrites the path's characters from the start.
+        if(root && Length()) { Intact = 0; }
+
+        // Reserve enough room for the worst case up front; Every component written is preceded by a separator in the other path,
+        // except for the first one, and a drive without a separator gains one.
+        Buffer.Grow(length + path.Length() + 1);
+        Byte* data = Buffer.Data();
+
+        // An absolute path replaces the path, starting with its normalized root.
+        if(root == 1) { data[length++] = Separator; }
+        else if(root) { data[0] = path[0]; data[1] = ':'; data[2] = Separator; length = 3; }
+
+        // Helper
+        Int base = Root(StringView(data, length));
+
+        // Append the components one at a time.
+        for(Int offset = root; offset < path.Length();)
+        {
+            // Find the end of the component.
+            Int end = path.FindAny("/\\", offset);
+            StringView component = path.Slice(offset, end - offset);
+            offset = end + 1;
+
+            // Empty and current directory components don't change the path.
+            if(!component.Length() || (component == ".")) { continue; }
+
+            // Parent directory components remove the last component, unless there's none to remove (or it's a parent directory too).
+            if(component == "..")
+            {
+                // Locate the last component.
+                Int separator = (length > base) ? StringView(data, length).rFind(Separator) : -1;
+                Int start = (separator < base) ? base : separator + 1;
+
+                if((length > base) && (StringView(data + start, length - start) != ".."))
+                {
+                    // Remove the component and its separator.
+                    length = (separator < base) ? base : separator;
+                    // The hash has to be recomputed if characters it covered were removed, and the characters from there on may be rewritten.
+                    rehash |= (length < hashed);
+                    Intact = (length < Intact) ? length : Intact;
+                    // -- //
+                    continue;
+                }
+
+                // There's nothing above the root.
+                if(base) { continue; }
+            }
+
+            // Append the separator and the component.
+            if(length > base) { data[length++] = Separator; }
+            // -- //
+            Memory::Copy(data + length, component.Data(), component.Length());
+            length += component.Length();
+        }
+
+        // Update the length and extend the hash over the new characters (or recompute it).
+        Buffer.Terminate(length);
+        Digest = rehash ? Hash::FNV32(data, length) : Hash::FNV32(data + hashed, length - hashed, Digest);
+        // -- //
+        return *this;
+    };
+
+    // ----------------------------------------------------------------------------------------
+    Void Path::Truncate(Int length)
+    {
+        // Debug check
+        Assert((length >= 0) && (length <= Length()), "Cannot truncate a path to an invalid length.");
+
+        // Shorten the path and recompute the hash.
+        Buffer.Terminate(length);
+        Digest = Hash::FNV32(Buffer.Data(), length);
+        Intact = Whole;
+    };
+
+    // ----------------------------------------------------------------------------------------
+    Void Path::Truncate(Int length, uInt digest)
+    {
+        // Debug checks
+        Assert((length >= 0) && (length <= Length()), "Cannot truncate a path to an invalid length.");
+        Assert(length <= Intact, "Cannot restore the hash of a path whose characters were rewritten by a join since it had that length.");
+
+        // Shorten the path and restore the hash, unless the characters it covered were rewritten.
+        Buffer.Terminate(length);
+        Digest = (length <= Intact) ? digest : Hash::FNV32(Buffer.Data(), length);
+        Intact = Whole;
+    };
+
+    // ----------------------------------------------------------------------------------------
+    uInt Hash::FNV32(const Path& path)
+    {
+        return path.Hash();
+    };
+}
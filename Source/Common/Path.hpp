@@ -0,0 +1,176 @@
+/*
+-------------------------------------------------------------------------------
+    Filename: Common/Path.hpp
+-------------------------------------------------------------------------------
+*/
+
+// Header guard
+#pragma once
+// Includes
+#include "..\Common.hpp"
+#include "..\Common\Hash.hpp"
+#include "..\Common\String.hpp"
+#include "..\Common\StringView.hpp"
+
+// --------------------------------------------------------------------------------------------
+namespace R2D
+{
+    // ----------------------------------------------------------------------------------------
+    // Filesystem path, kept in a normalized form so equal locations compare (and hash) equal no matter how they were written.
+    // Both Windows ("C:\Folder\File.txt") and POSIX ("/folder/file.txt") paths are accepted and stored with forward slashes,
+    // without repeated separators, "." components or a trailing separator. ".." components are resolved against the component
+    // before them where there is one, and dropped at the root. The hash of the characters is kept up to date as the path changes,
+    // so paths make cheap map keys, and the queries return views into the path without allocating.
+    class Path
+    {
+    public:
+        // Constants
+
+        // The separator paths are stored with. Windows accepts it as well as its native backslash.
+        static constexpr Byte Separator = '/';
+        // The value of Intact when no characters have been rewritten.
+        static constexpr Int Whole = 0x7FFFFFFF;
+
+    private:
+        // Members
+
+        // The normalized characters of the path.
+        String Buffer;
+        // The 32-bit FNV-1a hash of the characters.
+        uInt Digest;
+        // The number of leading characters that no Join() has rewritten since the path was created, assigned or last truncated; A join
+        // with ".." components can remove characters and write others in their place. Whole if nothing was rewritten.
+        Int Intact;
+
+    public:
+        // Constructors
+
+        // Default constructor. Creates an empty (relative) path.
+        Path() : Buffer(), Digest(Hash::FNV32("")), Intact(Whole) {};
+        // View constructor. Normalizes the characters referenced by the view.
+        explicit Path(const StringView& path) : Path() { Join(path); Intact = Whole; };
+        // C-string constructor. Normalizes the string.
+        template <size_t size> Path(const char(&path)[size]) : Path() { Join(StringView(path)); Intact = Whole; };
+        // Copy constructor.
+        Path(const Path& other) : Buffer(other.Buffer), Digest(other.Digest), Intact(Whole) {};
+        // Move constructor.
+        Path(Path&& other) : Buffer(R2D::Move(other.Buffer)), Digest(other.Digest), Intact(Whole) { other.Digest = Hash::FNV32(""); other.Intact = Whole; };
+
+        // Operators
+
+        // Copy assignment operator.
+        Path& operator = (const Path& other)
+        {
+            Buffer = other.Buffer;
+            Digest = other.Digest;
+            Intact = Whole;
+            // -- //
+            return *this;
+        };
+
+        // Move assignment operator.
+        Path& operator = (Path&& other)
+        {
+            Buffer = R2D::Move(other.Buffer);
+            Digest = other.Digest;
+            Intact = Whole;
+            other.Digest = Hash::FNV32("");
+            other.Intact = Whole;
+            // -- //
+            return *this;
+        };
+
+        // Equality operators. The hashes are compared first, so unequal paths rarely need their characters compared.
+        Bool operator == (const Path& other) const { return (Digest == other.Digest) && (View() == other.View()); }
+        Bool operator != (const Path& other) const { return !(*this == other); }
+
+        // View conversion operator.
+        operator StringView() const { return View(); };
+
+        // Join operator. See Join().
+        Path& operator /= (const StringView& path) { return Join(path); };
+        // Join operator. Returns a copy of the path with another path joined to it. See Join().
+        Path operator / (const StringView& path) const { Path result(*this); result.Join(path); return result; };
+
+        // Methods
+
+        // The normalized characters of the path. Always null-terminated.
+        const Byte* Data() const
+        {
+            return Buffer.Data();
+        };
+
+        // The number of characters in the path.
+        Int Length() const
+        {
+            return Buffer.Length();
+        };
+
+        // View the characters of the path.
+        StringView View() const
+        {
+            return Buffer;
+        };
+
+        // The hash of the path's characters. Equal to Hash::FNV32(View()).
+        uInt Hash() const
+        {
+            return Digest;
+        };
+
+        // The number of characters in the root of the path; 1 for "/", 3 for a drive like "C:/" and 0 for a relative path.
+        Int Root() const;
+        // Static; The number of characters in the root of a path that hasn't been normalized yet, where a drive may lack its separator.
+        // Non-zero if joining the path would replace the path it's joined onto.
+        static Int Root(const StringView& path);
+
+        // Check if the path is absolute (has a root).
+        Bool Absolute() const
+        {
+            return Root() > 0;
+        };
+
+        // The path of the parent directory, e.g. "a/b" for "a/b/c.txt". Empty for a single relative component, and the root for the root.
+        StringView Parent() const;
+        // The last component of the path, e.g. "c.txt" for "a/b/c.txt". Empty for the root.
+        StringView Name() const;
+        // The last component of the path without its extension, e.g. "c" for "a/b/c.txt".
+        StringView Stem() const;
+        // The extension of the last component, without the period, e.g. "txt" for "a/b/c.txt". Empty if it doesn't have one.
+        // A leading period (as in ".hidden") doesn't begin an extension.
+        StringView Extension() const;
+
+        // Append another path to the path, normalizing it along the way. If the other path is absolute it replaces the path instead.
+        // Appending only extends the hash, so repeatedly joining onto the same path object reuses its storage and never rehashes it.
+        Path& Join(const StringView& path);
+
+        // Shorten the path to a previous length, e.g. the length it had before a Join(). Keeps the capacity for the next join.
+        // The remaining characters are rehashed; Loops that keep returning to the same length should use the overload below.
+        Void Truncate(Int length);
+        // Shorten the path to a previous length and restore the hash it had at that length (what Hash() returned back then), without rehashing.
+        // Only valid if the joins since then kept the characters below that length, i.e. their ".." components never went above it, so the
+        // path returns to exactly what it was; Otherwise it asserts, and rehashes the characters that are left.
+        Void Truncate(Int length, uInt digest);
+
+        // Check if the characters below a length are the same as when the path was created, assigned or last truncated, i.e. whether
+        // Truncate(length, digest) can return to that length.
+        Bool Keeps(Int length) const
+        {
+            return length <= Intact;
+        };
+
+        // Remove the path's characters, keeping the capacity.
+        Void Clear()
+        {
+            Truncate(0);
+        };
+
+        // Release the path's storage.
+        Void Release()
+        {
+            Buffer.Release();
+            Digest = Hash::FNV32("");
+            Intact = Whole;
+        };
+    };
+}
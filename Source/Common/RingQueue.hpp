@@ -0,0 +1,197 @@
+/*
+-------------------------------------------------------------------------------
+    Filename: Common/RingQueue.hpp
+-------------------------------------------------------------------------------
+*/
+
+// Header guard
+#pragma once
+// Includes
+#include "..\Common.hpp"
+#include "..\Common\Memory.hpp"
+// Namespace pollution (required for atomics).
+#include <atomic>
+
+// --------------------------------------------------------------------------------------------
+namespace R2D
+{
+    // ----------------------------------------------------------------------------------------
+    // Bounded first-in first-out queue for handing objects from exactly one producer thread to exactly one consumer thread without locks.
+    // The producer's and consumer's positions live on separate cache lines, each next to a cached copy of the other side's position,
+    // so neither side touches the other's cache line unless the queue looks full (or empty) from its cached copy.
+    // Objects can be staged and then published together, so a batch costs the consumer a single cache line transfer.
+    template <typename Type> class RingQueue
+    {
+    public:
+        // Constants
+
+        // The size of a cache line. Members written by different threads are kept this far apart to avoid false sharing.
+        static constexpr Int CacheLine = 64;
+
+    public:
+        // Members
+
+        // The position of the next object to pop. Only written by the consumer.
+        alignas(CacheLine) std::atomic<Long> Head;
+        // The consumer's copy of Tail, refreshed when the queue looks empty.
+        Long TailCache;
+
+        // The position after the last published object. Only written by the producer.
+        alignas(CacheLine) std::atomic<Long> Tail;
+        // The producer's copy of Head, refreshed when the queue looks full.
+        Long HeadCache;
+        // The position after the last staged object. Equal to Tail when nothing is waiting to be published.
+        Long Staged;
+
+        // The storage for the objects.
+        alignas(CacheLine) Type* Data;
+        // The number of objects the queue can hold. Always a power of two.
+        Int Capacity;
+
+    public:
+        // Constructors
+
+        // Default constructor.
+        RingQueue() : Head(0), TailCache(0), Tail(0), HeadCache(0), Staged(0), Data(nullptr), Capacity(0) {};
+        // Copy constructor.
+        RingQueue(const RingQueue& other) = delete;
+        // Move constructor.
+        RingQueue(RingQueue&& other) = delete;
+        // Destructor.
+        ~RingQueue() { Release(); };
+
+        // Methods
+
+        // Allocate the queue with the specified capacity, which must be a power of two. Not thread-safe.
+        Void Expand(Int capacity)
+        {
+            // Debug checks
+            Assert(!Data, "Attempting to allocate a queue that has already been allocated.");
+            Assert(POPCNT(capacity) == 1, "Cannot create queues whose capacities aren't a power of 2.");
+
+            // Allocate the storage.
+            Data = (Type*)Memory::Request(sizeof(Type) * capacity, (alignof(Type) > 16) ? alignof(Type) : 16);
+            Capacity = capacity;
+        };
+
+        // Destruct the remaining objects (published or not) and release the storage. Not thread-safe.
+        Void Release()
+        {
+            // Destruct every object between the consumer and the producer.
+            for(Long i = Head.load(); i < Staged; i++) { Data[i & (Capacity - 1)].~Type(); }
+
+            // Release the storage and reset the positions.
+            if(Data) { Memory::Free(Data); Data = nullptr; }
+            Capacity = 0;
+            Head.store(0);
+            Tail.store(0);
+            TailCache = HeadCache = Staged = 0;
+        };
+
+        // Producer; Construct an object at the end of the queue without publishing it yet. Returns false if the queue is full.
+        template <typename... Arguments> Bool Stage(Arguments&&... arguments)
+        {
+            // Check for room using the cached consumer position first, only reading the real one if that looks full.
+            if(Staged - HeadCache == Capacity)
+            {
+                HeadCache = Head.load(std::memory_order_acquire);
+                // -- //
+                if(Staged - HeadCache == Capacity) { return false; }
+            }
+
+            // Construct the object in-place.
+            new(Data + (Staged & (Capacity - 1)))Type(Forward<Arguments>(arguments)...);
+            Staged++;
+            // -- //
+            return true;
+        };
+
+        // Producer; Make the staged objects visible to the consumer.
+        Void Publish()
+        {
+            Tail.store(Staged, std::memory_order_release);
+        };
+
+        // Producer; Construct an object at the end of the queue and publish it. Returns false if the queue is full.
+        template <typename... Arguments> Bool Push(Arguments&&... arguments)
+        {
+            // Stage the object and publish it straight away.
+            if(!Stage(Forward<Arguments>(arguments)...)) { return false; }
+            // -- //
+            Publish();
+            return true;
+        };
+
+        // Producer; Copy a batch of objects to the end of the queue and publish them at once. Returns the number of objects pushed,
+        // which is less than count if the queue fills up.
+        Int PushMany(const Type* objects, Int count)
+        {
+            Int pushed = 0;
+            // Stage as many objects as fit.
+            for(; (pushed < count) && Stage(objects[pushed]); pushed++) {}
+            // -- //
+            if(pushed) { Publish(); }
+            return pushed;
+        };
+
+        // Consumer; Move the object at the front of the queue into the output and remove it. Returns false if the queue is empty.
+        Bool Pop(Type& output)
+        {
+            // Helper
+            Long head = Head.load(std::memory_order_relaxed);
+
+            // Check for objects using the cached producer position first, only reading the real one if that looks empty.
+            if(head == TailCache)
+            {
+                TailCache = Tail.load(std::memory_order_acquire);
+                // -- //
+                if(head == TailCache) { return false; }
+            }
+
+            // Move the object out and destruct it.
+            Type& object = Data[head & (Capacity - 1)];
+            output = R2D::Move(object);
+            object.~Type();
+
+            // Hand the slot back to the producer.
+            Head.store(head + 1, std::memory_order_release);
+            // -- //
+            return true;
+        };
+
+        // Consumer; Move up to count objects from the front of the queue into the output array and remove them at once.
+        // Returns the number of objects popped.
+        Int PopMany(Type* output, Int count)
+        {
+            // Helper
+            Long head = Head.load(std::memory_order_relaxed);
+
+            // Refresh the producer position if the cached one doesn't cover the whole request.
+            if(TailCache - head < count) { TailCache = Tail.load(std::memory_order_acquire); }
+
+            // Move the available objects out.
+            Int popped = Int((TailCache - head < count) ? TailCache - head : count);
+            // -- //
+            for(Int i = 0; i < popped; i++)
+            {
+                Type& object = Data[(head + i) & (Capacity - 1)];
+                output[i] = R2D::Move(object);
+                object.~Type();
+            }
+
+            // Hand the slots back to the producer.
+            if(popped) { Head.store(head + popped, std::memory_order_release); }
+            // -- //
+            return popped;
+        };
+
+        // The number of published objects in the queue. Only a snapshot if the other thread is active.
+        Int Count() const
+        {
+            // Read the consumer position first, so the producer position read after it can't be behind it.
+            Long head = Head.load(std::memory_order_acquire);
+            // -- //
+            return Int(Tail.load(std::memory_order_acquire) - head);
+        };
+    };
+}
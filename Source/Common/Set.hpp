@@ -10,8 +10,9 @@
 #include "..\Common.hpp"
 #include "..\Common\Hash.hpp"
 #include "..\Common\Memory.hpp"
+// Namespace pollution (required for prefetch intrinsics).
+#include <xmmintrin.h>
 
-// TODO: Set can only contain a maximum of 4,096 entries due to having only a single BitSet for the bucket index hardcoded. Considering using a doubly-linked list instead.
 // TODO: Probing doesn't take advantage of the internal acceleration structures. Use them maybe, somehow?
 
 // --------------------------------------------------------------------------------------------
@@ -116,7 +117,7 @@ namespace R2D
                 else
                 {
                     // Attempt to locate the next bucket that contains keys.
-                    bucket = Handle->Index.Mask.Peek(slot);
+                    bucket = Handle->Occupied(bucket + 1);
 
                     // If there aren't anymore buckets with active keys..
                     if(bucket < 0)
@@ -148,8 +149,8 @@ namespace R2D
         Key* Data;
         // Array of buckets describing groups of keys in the set.
         Bucket* Buckets;
-        // Index denoting which buckets contain active keys. Being hardcoded to a single BitSet like this limits this to only 4,096 entries.
-        BitSet Index;
+        // Array of bitsets denoting which buckets contain active keys, with one bitset for every 64 buckets.
+        BitSet* Index;
         // The number of active keys in the set.
         Int Count;
         // The maximum number of keys the set can contain.
@@ -159,11 +160,11 @@ namespace R2D
         // Constructors
 
         // Default constructor.
-        Set() : Data(nullptr), Buckets(nullptr), Index(), Count(0), Capacity(0) {};
+        Set() : Data(nullptr), Buckets(nullptr), Index(nullptr), Count(0), Capacity(0) {};
         // Copy constructor.
         Set(const Set& other) = delete;
         // Move constructor.
-        Set(Set&& other) : Data(other.Data), Buckets(other.Buckets), Index(R2D::Move(other.Index)), Count(other.Count), Capacity(other.Capacity) { other.Data = nullptr; other.Buckets = nullptr; other.Count = 0; other.Capacity = 0; };
+        Set(Set&& other) : Data(other.Data), Buckets(other.Buckets), Index(other.Index), Count(other.Count), Capacity(other.Capacity) { other.Data = nullptr; other.Buckets = nullptr; other.Index = nullptr; other.Count = 0; other.Capacity = 0; };
         // Destructor.
         ~Set() { Release(); };
 
@@ -184,19 +185,26 @@ namespace R2D
             // Debug check
             Assert(POPCNT(Capacity) == 1, "Cannot create sets whose capacities aren't a power of two.");
 
-            // Allocate one bucket for every 64 keys.
+            // Allocate one bucket for every 64 keys, and one bitset of the index for every 64 buckets.
             Int buckets = ((Capacity - 1) / 64) + 1;
+            Int words = ((buckets - 1) / 64) + 1;
 
-            Int size[2];
-            // Compute the memory footprints of the key buffer and bucket buffer.
+            Int size[3];
+            // Compute the memory footprints of the key buffer, bucket buffer and index.
             size[0] = sizeof(Key) * Capacity;
             size[1] = sizeof(Bucket) * buckets;
+            size[2] = sizeof(BitSet) * words;
 
             // Request the new memory and assign the pointers.
-            Byte* memory = (Byte*)Memory::Resize(Data, size[0] + size[1]);
+            Byte* memory = (Byte*)Memory::Resize(Data, size[0] + size[1] + size[2]);
             // -- //
             Data = (Key*)(memory);
             Buckets = (Bucket*)(memory + size[0]);
+            Index = (BitSet*)(memory + size[0] + size[1]);
+
+            // Construct the buckets and the index, which the keys' states are read from.
+            for(Int i = 0; i < buckets; i++) { new(Buckets + i)Bucket(); }
+            for(Int i = 0; i < words; i++) { new(Index + i)BitSet(); }
 
             // Iterate through the old set and add all of its active keys to this new set.
             for(auto iterator = old.First(); !iterator.Last(); iterator.Next())
@@ -223,19 +231,22 @@ namespace R2D
             // Debug check
             Assert(POPCNT(Capacity) == 1, "Cannot create sets whose capacities aren't a power of two.");
 
-            // Allocate one bucket for every 64 keys.
+            // Allocate one bucket for every 64 keys, and one bitset of the index for every 64 buckets.
             Int buckets = ((Capacity - 1) / 64) + 1;
+            Int words = ((buckets - 1) / 64) + 1;
 
-            Int size[2];
-            // Compute the memory footprints of the key buffer and bucket buffer.
+            Int size[3];
+            // Compute the memory footprints of the key buffer, bucket buffer and index.
             size[0] = sizeof(Key) * Capacity;
             size[1] = sizeof(Bucket) * buckets;
+            size[2] = sizeof(BitSet) * words;
 
             // Request the new memory and assign the pointers.
-            Byte* memory = (Byte*)Memory::Resize(Data, size[0] + size[1]);
+            Byte* memory = (Byte*)Memory::Resize(Data, size[0] + size[1] + size[2]);
             // -- //
             Data = (Key*)(memory);
             Buckets = (Bucket*)(memory + size[0]);
+            Index = (BitSet*)(memory + size[0] + size[1]);
 
             // Default construct all of the Key objects.
             for(Int i = 0; i < Capacity; i++)
@@ -249,6 +260,8 @@ namespace R2D
                 // Call the default constructor.
                 new(Buckets + i)Bucket();
             }
+            // Construct the index.
+            for(Int i = 0; i < words; i++) { new(Index + i)BitSet(); }
 
             // Iterate through the old set and add all of its active keys to this new set.
             for(auto iterator = old.First(); !iterator.Last(); iterator.Next())
@@ -267,7 +280,7 @@ namespace R2D
             if(Data) { Memory::Free(Data); Data = nullptr; }
             // -- //
             Buckets = nullptr;
-            Index.Reset();
+            Index = nullptr;
             Count = 0;
             Capacity = 0;
         };
@@ -283,7 +296,7 @@ namespace R2D
             if(Count)
             {
                 // Locate the first key's index and start the iterator there.
-                Int bucket = Index.Peek();
+                Int bucket = Occupied(0);
                 iterator.Index = (bucket * 64) + Buckets[bucket].Active.Peek();
             }
             else
@@ -295,6 +308,24 @@ namespace R2D
             return iterator;
         };
 
+        // Retrieve the index of the first bucket at or after the specified one that contains keys, or -1 if there are none.
+        Int Occupied(Int bucket) const
+        {
+            // Helper
+            Int buckets = ((Capacity - 1) / 64) + 1;
+
+            // Scan the index, skipping the buckets before the specified one in its bitset.
+            for(Int word = bucket >> 6; (word << 6) < buckets; word++)
+            {
+                uLong mask = Index[word].Mask;
+                // -- //
+                if(word == (bucket >> 6)) { mask &= ~0ULL << (bucket & 63); }
+                if(mask) { return (word << 6) + BitScanForward(mask); }
+            }
+            // -- //
+            return -1;
+        };
+
         // Construct a new key in-place with the specified key.
         Int Add(const Key& key)
         {
@@ -307,7 +338,7 @@ namespace R2D
             Int bucket = slot >> 6;
 
             // Linear probing only needs to be done if the bucket isn't empty.
-            if(Index.Get(bucket))
+            if(Index[bucket >> 6].Get(bucket & 63))
             {
                 // Linearly probe the set if the current slot already contains an active key.
                 while(Buckets[bucket].Active.Get(slot & 63))
@@ -319,7 +350,8 @@ namespace R2D
                     Buckets[bucket].Collided.Set(slot & 63);
 
                     // Move to the next slot and update the bucket index;
-                    bucket = (++slot & (Capacity - 1)) >> 6;
+                    slot = (slot + 1) & (Capacity - 1);
+                    bucket = slot >> 6;
                 }
             }
 
@@ -327,7 +359,7 @@ namespace R2D
             Count++;
 
             // Flag the bucket as containing keys.
-            Index.Set(bucket);
+            Index[bucket >> 6].Set(bucket & 63);
             // Flag the key in the bucket as active.
             Buckets[bucket].Active.Set(slot & 63);
 
@@ -345,8 +377,60 @@ namespace R2D
             // Return an invalid index if the set is unallocated.
             if(!Data) { return -1; }
 
-            // Mask the hashed key to compute the slot index and bucket index.
-            Int slot = Hash::FNV32(key) & (Capacity - 1);
+            // Mask the hashed key to compute the slot index and probe from there.
+            return Probe(key, Hash::FNV32(key) & (Capacity - 1));
+        };
+
+        // Lookup a batch of keys, writing each one's index (or -1 if it wasn't found) to the output array.
+        // In tables larger than a few MiB, the keys are hashed and their buckets prefetched a few lookups ahead of being probed, so the
+        // cache misses of consecutive lookups overlap instead of being paid one after another as when calling Find() in a loop.
+        Void FindMany(const Key* keys, Int count, Int* output) const
+        {
+            // Nothing can be found if the set is unallocated.
+            if(!Data)
+            {
+                for(Int i = 0; i < count; i++) { output[i] = -1; }
+                return;
+            }
+
+            // Like Map::FindMany(), sets small enough to stay in the caches are probed one key after another, since prefetching
+            // only pays off once the lookups miss.
+            if(Long(Capacity) * sizeof(Key) < (Long(1) << 22))
+            {
+                for(Int i = 0; i < count; i++) { output[i] = Probe(keys[i], Hash::FNV32(keys[i]) & (Capacity - 1)); }
+                return;
+            }
+
+            // How many lookups ahead the keys are hashed and prefetched. Must be a power of two.
+            constexpr Int Distance = 8;
+            // Ring of the precomputed slots of the lookups in flight.
+            Int slots[Distance];
+
+            // Run the hashing stage Distance lookups ahead of the probing stage. Probing first frees up the ring slot the next key is hashed into.
+            for(Int i = 0; i < (count + Distance); i++)
+            {
+                // Probe the key that was prefetched Distance lookups ago.
+                Int j = i - Distance;
+                // -- //
+                if(j >= 0) { output[j] = Probe(keys[j], slots[j & (Distance - 1)]); }
+
+                // Hash the next key and prefetch the memory its probe will start on.
+                if(i < count)
+                {
+                    Int slot = Hash::FNV32(keys[i]) & (Capacity - 1);
+                    // -- //
+                    _mm_prefetch((const char*)(Buckets + (slot >> 6)), _MM_HINT_T0);
+                    _mm_prefetch((const char*)(Data + slot), _MM_HINT_T0);
+                    slots[i & (Distance - 1)] = slot;
+                }
+            }
+        };
+
+        // Lookup a key by linearly probing from the specified slot, which should be the slot the key hashes to.
+        // Used internally by Find() and FindMany().
+        Int Probe(const Key& key, Int slot) const
+        {
+            // Compute the bucket index.
             Int bucket = slot >> 6;
 
             // Loop through (potentially) every key in the set to locate a matching key.
@@ -371,7 +455,8 @@ namespace R2D
                 }
 
                 // Move to the next key and update the bucket index.
-                bucket = (++slot & (Capacity - 1)) >> 6;
+                slot = (slot + 1) & (Capacity - 1);
+                bucket = slot >> 6;
             }
 
             // A matching key wasn't found.
@@ -391,7 +476,7 @@ namespace R2D
                 // Deactivate the key.
                 Buckets[bucket].Active.Reset(index & 63);
                 // Deactivate the bucket if it's now empty.
-                if(Buckets[bucket].Active.Mask == 0) { Index.Reset(bucket); }
+                if(Buckets[bucket].Active.Mask == 0) { Index[bucket >> 6].Reset(bucket & 63); }
 
                 // Reconstruct the key.
                 Data[index] = Key();
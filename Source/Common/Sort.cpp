@@ -0,0 +1,199 @@
+/*
+-------------------------------------------------------------------------------
+    Filename: Common/Sort.cpp
+-------------------------------------------------------------------------------
+*/
+
+// Includes
+#include "..\Common\Sort.hpp"
+// -- //
+#include <barrier>
+#include <thread>
+
+// --------------------------------------------------------------------------------------------
+namespace R2D
+{
+    // The number of key bits sorted by each pass. Eleven bits take three passes for 32-bit keys and six for 64-bit keys,
+    // while the counts of a pass still fit in the L1 cache.
+    static constexpr Int sortBits = 11;
+    // The number of distinct digit values in a pass.
+    static constexpr Int sortDigits = 1 << sortBits;
+
+    // ----------------------------------------------------------------------------------------
+    // Count how many keys have each value of every digit, all passes at once. Returns a mask of the passes that are needed;
+    // A pass whose digit is the same for every key doesn't change the order and is skipped.
+    template <typename Entry> static uInt SortHistogram(const Entry* keys, Int count, Int (*counts)[sortDigits])
+    {
+        // Helper
+        constexpr Int passes = (sizeof(Entry::Key) * 8 + sortBits - 1) / sortBits;
+
+        // Clear the counts.
+        Memory::Zero(counts, sizeof(Int) * sortDigits * passes);
+
+        // Count every digit of every key.
+        for(Int i = 0; i < count; i++)
+        {
+            auto key = keys[i].Key;
+            // -- //
+            for(Int pass = 0; pass < passes; pass++) { counts[pass][(key >> (pass * sortBits)) & (sortDigits - 1)]++; }
+        }
+
+        // Check which passes are needed.
+        uInt needed = 0;
+        for(Int pass = 0; pass < passes; pass++)
+        {
+            if(counts[pass][(keys[0].Key >> (pass * sortBits)) & (sortDigits - 1)] != count) { needed |= 1u << pass; }
+        }
+        // -- //
+        return needed;
+    };
+
+    // ----------------------------------------------------------------------------------------
+    // Distribute a range of keys by one of their digits, given where the first key with each digit value goes.
+    template <typename Entry> static Void SortScatter(const Entry* source, Int begin, Int end, Entry* destination, Int pass, Int* offsets)
+    {
+        for(Int i = begin; i < end; i++)
+        {
+            destination[offsets[(source[i].Key >> (pass * sortBits)) & (sortDigits - 1)]++] = source[i];
+        }
+    };
+
+    // ----------------------------------------------------------------------------------------
+    template <typename Entry> static Void SortRadix(Entry* keys, Int count, Entry* scratch)
+    {
+        // Short ranges are faster to sort directly.
+        if(count <= 64)
+        {
+            auto less = [](const Entry& a, const Entry& b) { return a.Key < b.Key; };
+            // -- //
+            Sort::Insertion(keys, count, less);
+            return;
+        }
+
+        // Helpers
+        constexpr Int passes = (sizeof(Entry::Key) * 8 + sortBits - 1) / sortBits;
+        Int counts[passes][sortDigits];
+        Entry* source = keys;
+        Entry* destination = scratch;
+
+        // Count the digits of every key in a single read.
+        uInt needed = SortHistogram(keys, count, counts);
+
+        // Sort by each digit from least to most significant, alternating between the keys and the scratch.
+        for(Int pass = 0; pass < passes; pass++)
+        {
+            // -- //
+            if(!(needed & (1u << pass))) { continue; }
+
+            // Turn the counts into the positions where each digit value starts.
+            Int offsets[sortDigits];
+            for(Int i = 0, sum = 0; i < sortDigits; i++) { offsets[i] = sum; sum += counts[pass][i]; }
+
+            // Distribute the keys.
+            SortScatter(source, 0, count, destination, pass, offsets);
+            // -- //
+            Entry* swap = source; source = destination; destination = swap;
+        }
+
+        // Copy the result back if it ended up in the scratch.
+        if(source != keys) { Memory::Copy(keys, source, sizeof(Entry) * count); }
+    };
+
+    // ----------------------------------------------------------------------------------------
+    template <typename Entry> static Void SortParallel(Entry* keys, Int count, Entry* scratch)
+    {
+        // Helpers
+        constexpr Int passes = (sizeof(Entry::Key) * 8 + sortBits - 1) / sortBits;
+        Int threads = Int(std::thread::hardware_concurrency());
+
+        // Give every thread at least a quarter of the threshold, otherwise the synchronization isn't worth it.
+        if(threads > count / (Sort::Threshold / 4)) { threads = count / (Sort::Threshold / 4); }
+        if(threads > 64) { threads = 64; }
+        // -- //
+        if((count < Sort::Threshold) || (threads < 2)) { SortRadix(keys, count, scratch); return; }
+
+        // The digit counts of each thread's range of keys, for the current pass.
+        Int (*counts)[sortDigits] = (Int(*)[sortDigits])Memory::Request(sizeof(Int) * sortDigits * threads);
+        // The digit counts of all the keys, used to skip the passes that aren't needed.
+        Int totals[passes][sortDigits];
+        uInt needed = SortHistogram(keys, count, totals);
+
+        // Every pass, each thread counts the digits in its range of keys, then (once every thread has counted) computes where its keys
+        // with each digit value go; After the keys with a lower digit value, and after the keys with the same digit value
+        // in the ranges of the threads before it, which keeps the sort stable. Then it distributes its range.
+        std::barrier barrier(threads);
+        auto work = [&](Int thread)
+        {
+            // Helpers
+            Int begin = Int((Long(count) * thread) / threads);
+            Int end = Int((Long(count) * (thread + 1)) / threads);
+            Entry* source = keys;
+            Entry* destination = scratch;
+
+            for(Int pass = 0; pass < passes; pass++)
+            {
+                // -- //
+                if(!(needed & (1u << pass))) { continue; }
+
+                // Count the digits in the thread's range.
+                Memory::Zero(counts[thread], sizeof(Int) * sortDigits);
+                for(Int i = begin; i < end; i++) { counts[thread][(source[i].Key >> (pass * sortBits)) & (sortDigits - 1)]++; }
+                // -- //
+                barrier.arrive_and_wait();
+
+                // Compute where the thread's keys with each digit value start.
+                Int offsets[sortDigits];
+                for(Int i = 0, sum = 0; i < sortDigits; i++)
+                {
+                    offsets[i] = sum;
+                    for(Int j = 0; j < thread; j++) { offsets[i] += counts[j][i]; }
+                    sum += totals[pass][i];
+                }
+
+                // Distribute the range, then wait for the other threads before the next pass reads the result.
+                SortScatter(source, begin, end, destination, pass, offsets);
+                barrier.arrive_and_wait();
+                // -- //
+                Entry* swap = source; source = destination; destination = swap;
+            }
+        };
+
+        // Run the work on the helper threads and the calling thread.
+        std::thread* helpers = (std::thread*)Memory::Request(sizeof(std::thread) * (threads - 1));
+        for(Int i = 1; i < threads; i++) { new(helpers + (i - 1))std::thread(work, i); }
+        // -- //
+        work(0);
+        for(Int i = 1; i < threads; i++) { helpers[i - 1].join(); helpers[i - 1].~thread(); }
+
+        // Copy the result back if it ended up in the scratch.
+        if(POPCNT(needed) & 1) { Memory::Copy(keys, scratch, sizeof(Entry) * count); }
+
+        // Release the temporary memory.
+        Memory::Free(helpers);
+        Memory::Free(counts);
+    };
+
+    // ----------------------------------------------------------------------------------------
+    Void Sort::Radix(Key32* keys, Int count, Key32* scratch)
+    {
+        SortRadix(keys, count, scratch);
+    };
+
+    // ----------------------------------------------------------------------------------------
+    Void Sort::Radix(Key64* keys, Int count, Key64* scratch)
+    {
+        SortRadix(keys, count, scratch);
+    };
+
+    // ----------------------------------------------------------------------------------------
+    Void Sort::Parallel(Key32* keys, Int count, Key32* scratch)
+    {
+        SortParallel(keys, count, scratch);
+    };
+
+    // ----------------------------------------------------------------------------------------
+    Void Sort::Parallel(Key64* keys, Int count, Key64* scratch)
+    {
+        SortParallel(keys, count, scratch);
+    };
+}
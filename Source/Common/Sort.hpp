@@ -0,0 +1,209 @@
+/*
+-------------------------------------------------------------------------------
+    Filename: Common/Sort.hpp
+-------------------------------------------------------------------------------
+*/
+
+// Header guard
+#pragma once
+// Includes
+#include "..\Common.hpp"
+#include "..\Common\Array.hpp"
+#include "..\Common\Memory.hpp"
+
+// --------------------------------------------------------------------------------------------
+namespace R2D
+{
+    // ----------------------------------------------------------------------------------------
+    // Sorting for arrays. Objects that can be ordered by an integer, like draw items ordered by material and depth, should be sorted
+    // through keys: Build an array of Key32 or Key64 with each object's key and index, radix sort it and visit the objects
+    // through the sorted indices. Radix sorting is linear in the number of keys and stable. Anything else is sorted with Introsort().
+    namespace Sort
+    {
+        // A 32-bit sort key and the index of the object it belongs to.
+        struct Key32
+        {
+            // The sort key.
+            uInt Key;
+            // The index of the object the key belongs to.
+            uInt Index;
+        };
+
+        // A 64-bit sort key and the index of the object it belongs to.
+        struct Key64
+        {
+            // The sort key.
+            uLong Key;
+            // The index of the object the key belongs to.
+            uInt Index;
+        };
+
+        // The number of keys below which the parallel sorts just sort on the calling thread.
+        constexpr Int Threshold = 1 << 16;
+
+        // Convert a float to a key that sorts in the same order as the float (negative numbers included). NaNs sort after infinity.
+        inline uInt Key(Float value)
+        {
+            uInt bits;
+            Memory::Copy(&bits, &value, sizeof(bits));
+            // Flip every bit of negative numbers, and only the sign bit of positive ones.
+            return bits ^ (uInt(Int(bits) >> 31) | 0x80000000u);
+        };
+
+        // Convert a double to a key that sorts in the same order as the double (negative numbers included). NaNs sort after infinity.
+        inline uLong Key(Double value)
+        {
+            uLong bits;
+            Memory::Copy(&bits, &value, sizeof(bits));
+            // Flip every bit of negative numbers, and only the sign bit of positive ones.
+            return bits ^ (uLong(Long(bits) >> 63) | 0x8000000000000000ull);
+        };
+
+        // Combine two 32-bit keys into one 64-bit key that sorts by the major key first and the minor key second.
+        inline uLong Key(uInt major, uInt minor)
+        {
+            return (uLong(major) << 32) | minor;
+        };
+
+        // Stable LSD radix sort of keys by ascending key. Scratch must have room for count keys, and the result ends up in keys.
+        // Passes over key digits that are the same for every key are skipped, so narrow key ranges sort in fewer passes.
+        extern Void Radix(Key32* keys, Int count, Key32* scratch);
+        extern Void Radix(Key64* keys, Int count, Key64* scratch);
+
+        // Radix sort, spreading the passes over the available hardware threads. Gives the same result as Radix().
+        // Arrays smaller than Threshold are sorted on the calling thread.
+        extern Void Parallel(Key32* keys, Int count, Key32* scratch);
+        extern Void Parallel(Key64* keys, Int count, Key64* scratch);
+
+        // Radix sort an array of keys by ascending key. See Radix().
+        template <typename Entry> Void Radix(Array<Entry>& keys)
+        {
+            Entry* scratch = (Entry*)Memory::Request(sizeof(Entry) * keys.Count);
+            // -- //
+            Radix(keys.Data, keys.Count, scratch);
+            Memory::Free(scratch);
+        };
+
+        // Radix sort an array of keys by ascending key, using the available hardware threads. See Parallel().
+        template <typename Entry> Void Parallel(Array<Entry>& keys)
+        {
+            Entry* scratch = (Entry*)Memory::Request(sizeof(Entry) * keys.Count);
+            // -- //
+            Parallel(keys.Data, keys.Count, scratch);
+            Memory::Free(scratch);
+        };
+
+        // ------------------------------------------------------------------------------------
+        // Swap two objects through moves.
+        template <typename Type> inline Void Swap(Type& a, Type& b)
+        {
+            Type temporary(R2D::Move(a));
+            a = R2D::Move(b);
+            b = R2D::Move(temporary);
+        };
+
+        // ------------------------------------------------------------------------------------
+        // Stable insertion sort, for short ranges.
+        template <typename Type, typename Less> Void Insertion(Type* data, Int count, Less& less)
+        {
+            for(Int i = 1; i < count; i++)
+            {
+                // Shift the larger objects before the object up until its place is found.
+                if(less(data[i], data[i - 1]))
+                {
+                    Type object(R2D::Move(data[i]));
+                    Int j = i;
+                    // -- //
+                    for(; (j > 0) && less(object, data[j - 1]); j--) { data[j] = R2D::Move(data[j - 1]); }
+                    data[j] = R2D::Move(object);
+                }
+            }
+        };
+
+        // ------------------------------------------------------------------------------------
+        // Heapsort, used by Introsort() when partitioning degenerates.
+        template <typename Type, typename Less> Void Heap(Type* data, Int count, Less& less)
+        {
+            // Sift an object down the heap until both its children are smaller.
+            auto sift = [&](Int root, Int end)
+            {
+                for(Int child = root * 2 + 1; child < end; root = child, child = root * 2 + 1)
+                {
+                    if((child + 1 < end) && less(data[child], data[child + 1])) { child++; }
+                    if(!less(data[root], data[child])) { return; }
+                    // -- //
+                    Swap(data[root], data[child]);
+                }
+            };
+
+            // Build a max-heap, then repeatedly move its top to the end.
+            for(Int i = count / 2 - 1; i >= 0; i--) { sift(i, count); }
+            for(Int i = count - 1; i > 0; i--) { Swap(data[0], data[i]); sift(0, i); }
+        };
+
+        // ------------------------------------------------------------------------------------
+        // Introsort() with a recursion depth budget. Falls back to heapsort once the budget runs out.
+        template <typename Type, typename Less> Void Introsort(Type* data, Int count, Less& less, Int depth)
+        {
+            while(count > 16)
+            {
+                // Fall back to heapsort.
+                if(depth-- == 0) { Heap(data, count, less); return; }
+
+                // Order the first, middle and last objects and use the median as the pivot, which also guards both ends of the partition.
+                Int middle = count / 2;
+                if(less(data[middle], data[0])) { Swap(data[middle], data[0]); }
+                if(less(data[count - 1], data[middle])) { Swap(data[count - 1], data[middle]); if(less(data[middle], data[0])) { Swap(data[middle], data[0]); } }
+                // -- //
+                Type pivot(data[middle]);
+
+                // Partition the objects around the pivot (Hoare's scheme).
+                Int i = 0, j = count - 1;
+                while(true)
+                {
+                    while(less(data[++i], pivot)) {}
+                    while(less(pivot, data[--j])) {}
+                    // -- //
+                    if(i >= j) { break; }
+                    Swap(data[i], data[j]);
+                }
+
+                // Recurse into the smaller side and loop on the larger one, so the stack depth stays logarithmic.
+                Int left = j + 1;
+                // -- //
+                if(left < count - left) { Introsort(data, left, less, depth); data += left; count -= left; }
+                else { Introsort(data + left, count - left, less, depth); count = left; }
+            }
+
+            // Finish short ranges with insertion sort.
+            Insertion(data, count, less);
+        };
+
+        // Sort a range of objects using a comparator that returns true if its first argument goes before its second.
+        // Quicksort with median-of-three pivots, switching to heapsort if the recursion gets too deep (so the worst case stays O(n log n))
+        // and to insertion sort for short ranges. Not stable.
+        template <typename Type, typename Less> Void Introsort(Type* data, Int count, Less less)
+        {
+            // Allow about twice the depth of a balanced partitioning before giving up on quicksort.
+            Introsort(data, count, less, (count > 1) ? 2 * BitScanReverse(uInt(count)) : 0);
+        };
+
+        // Sort a range of objects in ascending order using operator <.
+        template <typename Type> Void Introsort(Type* data, Int count)
+        {
+            Introsort(data, count, [](const Type& a, const Type& b) { return a < b; });
+        };
+
+        // Sort an array using a comparator. See Introsort().
+        template <typename Type, typename Less> Void Introsort(Array<Type>& array, Less less)
+        {
+            Introsort(array.Data, array.Count, less);
+        };
+
+        // Sort an array in ascending order using operator <.
+        template <typename Type> Void Introsort(Array<Type>& array)
+        {
+            Introsort(array.Data, array.Count);
+        };
+    }
+}
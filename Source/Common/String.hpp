@@ -9,6 +9,7 @@
 // Includes
 #include "..\Common.hpp"
 #include "..\Common\Memory.hpp"
+#include "..\Common\StringView.hpp"
 // TODO: Move the Memory namespace calls to a source file, maybe?
 
 // TODO: Refactor the String class as I think it looks messy. Also rename Reserve to Resize (and add another function that actually Reserves capacity instead of resizing it).
@@ -16,37 +17,63 @@
 // --------------------------------------------------------------------------------------------
 namespace R2D
 {
+    // Strings of up to Inline characters are stored inside the object itself and never touch the heap. Longer strings are heap allocated.
+    // The storage never points into the object, so strings can be relocated bytewise like any other container entry.
     class String
     {
+        // The builder and paths write into the string's storage directly.
+        friend class StringBuilder;
+        friend class Path;
+
     public:
-        // The memory allocated for the string. Contains the characters and the null-byte at the end of the string.
-        Byte* Data;
-        // The number of characters in the string (not including the null-byte). Should always be less than Capacity, never equal to it, due to the null-byte at the end.
-        Int Length;
-        // The amount of memory allocated for the string. Includes the extra byte at the end of the buffer that is the null-byte.
-        Int Capacity;
+        // Constants
+
+        // The number of characters that can be stored inline (not including the null-byte).
+        static constexpr Int Inline = 22;
+        // Value of the inline length byte marking the string as heap allocated.
+        static constexpr Byte Allocated = -1;
+
+    private:
+        // Members
+
+        union
+        {
+            // Heap allocated storage, used once the string outgrows the inline storage.
+            struct
+            {
+                // The memory allocated for the string. Contains the characters and the null-byte at the end of the string.
+                Byte* Data;
+                // The number of characters in the string (not including the null-byte).
+                Int Length;
+                // The amount of memory allocated for the string, not including the extra byte for the null-byte.
+                Int Capacity;
+            } External;
+            // Inline storage. Contains the characters, the null-byte and, in the last byte, the length of the string (or Allocated).
+            Byte Internal[Inline + 2];
+        };
 
     public:
         // Constructors
 
         // Default constructor.
-        constexpr String() : Data(nullptr), Length(0), Capacity(0) {};
+        constexpr String() : Internal() {};
 
         // Single character constructor.
-        explicit String(char character) : Data(nullptr), Length(1), Capacity(0) { Reserve(1); Data[0] = character; Data[1] = 0; };
+        explicit String(char character) : Internal() { Internal[0] = character; Internal[Inline + 1] = 1; };
 
         // C-string constructor. Copies the string directly, including the null-byte.
-        template <size_t size> String(const char(&string)[size]) : Data(nullptr), Length(size - 1), Capacity(0)
+        template <size_t size> String(const char(&string)[size]) : Internal()
         {
             // Copy the contents of the other string without regard for parameter safety.
-            Reserve(Length);
-            Memory::Copy(Data, string, size);
+            Reserve(size - 1);
+            Memory::Copy(Data(), string, size);
+            Terminate(size - 1);
         };
 
         // C-string pointer constructor. Length does not include the null-byte at the end of the string, only the number of characters.
-        String(const char* string, Int length) : Data(nullptr), Length(length), Capacity(0)
+        String(const char* string, Int length) : Internal()
         {
-            // Only allocate the string if there's actual characters to copy over.
+            // Only copy the string if there's actual characters to copy over.
             if(length > 0)
             {
                 // Debug check
@@ -54,27 +81,32 @@ namespace R2D
 
                 // Copy over the contents from the other string.
                 Reserve(length);
-                Memory::Copy(Data, string, length);
+                Memory::Copy(Data(), string, length);
                 // Explicitly initialize the null-byte.
-                Data[length] = 0;
+                Terminate(length);
             }
         };
 
+        // View constructor. Copies the characters referenced by the view.
+        explicit String(const StringView& view) : String(view.Data(), view.Length()) {};
+
         // Copy constructor.
-        String(const String& other) : Data(nullptr), Length(other.Length), Capacity(0)
+        String(const String& other) : Internal()
         {
-            // Only attempt to copy data from the other string if it even has data.
-            if(other.Data)
-            {
-                // Ensure that the string is large enough to contain the other string's contents.
-                Reserve(Length);
-                // Copy over the other string's contents (including its implicit null-byte).
-                Memory::Copy(Data, other.Data, Length + 1);
-            }
+            // Ensure that the string is large enough to contain the other string's contents.
+            Reserve(other.Length());
+            // Copy over the other string's contents (including its implicit null-byte).
+            Memory::Copy(Data(), other.Data(), other.Length() + 1);
+            Terminate(other.Length());
         };
 
         // Move constructor.
-        String(String&& other) : Data(other.Data), Length(other.Length), Capacity(other.Capacity) { other.Data = nullptr; other.Length = 0; other.Capacity = 0; };
+        String(String&& other)
+        {
+            // Take over the other string's storage, whether inline or allocated, and leave it empty.
+            Memory::Copy(Internal, other.Internal, sizeof(Internal));
+            Memory::Zero(other.Internal, sizeof(Internal));
+        };
 
         ~String() { Release(); };
 
@@ -84,28 +116,26 @@ namespace R2D
         Byte& operator [] (Int index)
         {
             // Debug checks
-            Assert(Data, "Tried to access characters in an empty string.");
             Assert(index >= 0, "Tried to access characters with a negative index.");
-            Assert(index < Length, "Tried to access characters past the end of the string.");
+            Assert(index < Length(), "Tried to access characters past the end of the string.");
 
-            return Data[index];
+            return Data()[index];
         };
         // Const array access operator.
         const Byte& operator [] (Int index) const
         {
             // Debug checks
-            Assert(Data, "Tried to access characters in an empty string.");
             Assert(index >= 0, "Tried to access characters with a negative index.");
-            Assert(index < Length, "Tried to access characters past the end of the string.");
+            Assert(index < Length(), "Tried to access characters past the end of the string.");
 
-            return Data[index];
+            return Data()[index];
         };
 
         // Copy assignment operator.
         String& operator = (const String& other)
         {
             // Release the existing string
-            if(Data) { Memory::Free(Data); }
+            Release();
 
             // Copy the other string
             new(this)String(other);
@@ -117,32 +147,42 @@ namespace R2D
         String& operator = (String&& other)
         {
             // Release the existing string
-            if(Data) { Memory::Free(Data); }
+            Release();
 
             // Assimilate the other string
-            new(this)String(other);
+            new(this)String(R2D::Move(other));
 
             return *this;
         };
 
+        // View conversion operator.
+        operator StringView() const { return StringView(Data(), Length()); };
+
+        // Equality operators. Strings are equal if their characters are equal, e.g. when used as map keys.
+        Bool operator == (const String& other) const { return StringView(*this) == StringView(other); }
+        Bool operator != (const String& other) const { return !(*this == other); }
+
         // String concatenation assignment operator.
-        String& operator += (const String& other)
+        String& operator += (const StringView& other)
         {
             // If the other string has data
-            if(other.Data)
+            if(other.Length())
             {
-                // Debug check
-                Assert(other.Length >= 0, "Tried to concatenate a string with a negative length to this string.");
+                // Helpers
+                Int length = Length();
+                Bool aliased = (other.Data() >= Data()) && (other.Data() < Data() + length);
+                Int offset = aliased ? Int(other.Data() - Data()) : 0;
 
-                // Expand the string
-                Reserve(Length + other.Length);
+                // Expand the string. Growing may move the characters, so a view of this string is copied from its offset afterwards.
+                Grow(length + other.Length());
+                // -- //
+                const Byte* source = aliased ? Data() + offset : other.Data();
 
                 // Append the other string
-                Memory::Copy(Data + Length, other.Data, other.Length);
-                Length += other.Length;
+                Memory::Copy(Data() + length, source, other.Length());
 
-                // Update the null-byte
-                Data[Length] = 0;
+                // Update the length and the null-byte
+                Terminate(length + other.Length());
             }
 
             return *this;
@@ -154,12 +194,15 @@ namespace R2D
             // If the other string has data (other than the null-byte).
             if(size > 1)
             {
+                // Helper
+                Int length = Length();
+
                 // Expand the string (while removing the null-byte).
-                Reserve(Length + (size - 1));
+                Grow(length + (size - 1));
 
                 // Append the other string (including the null-byte).
-                Memory::Copy(Data + Length, string, size);
-                Length += size - 1;
+                Memory::Copy(Data() + length, string, size);
+                Terminate(length + (size - 1));
             }
 
             return *this;
@@ -168,142 +211,166 @@ namespace R2D
         // Character concatenation assignment operator.
         String& operator += (char character)
         {
+            // Helper
+            Int length = Length();
+
             // Expand the string.
-            Reserve(Length + 1);
+            Grow(length + 1);
 
             // Append the character.
-            Data[Length] = character;
-
-            // Increase the length of the string.
-            Length += 1;
+            Data()[length] = character;
 
-            // Update the null-byte.
-            Data[Length] = 0;
+            // Increase the length of the string and update the null-byte.
+            Terminate(length + 1);
 
             return *this;
         };
 
         // String concatenation operator.
-        String operator + (const String& other) const
+        String operator + (const StringView& other) const
         {
-            // If this string has data (concatenation target)..
-            if(Data)
-            {
-                // If the other string has data for concatenation..
-                if(other.Data)
-                {
-                    String string;
-                    // Allocate a string for containing both strings.
-                    string.Reserve(Length + other.Length);
-
-                    // Append the strings.
-                    Memory::Copy(string.Data, Data, Length);
-                    Memory::Copy(string.Data + Length, other.Data, other.Length);
+            String string;
+            // Allocate a string for containing both strings.
+            string.Reserve(Length() + other.Length());
 
-                    //  Set the length of the string.
-                    string.Length = Length + other.Length;
+            // Append the strings.
+            Memory::Copy(string.Data(), Data(), Length());
+            Memory::Copy(string.Data() + Length(), other.Data(), other.Length());
 
-                    // Set the null-byte.
-                    string.Data[string.Length] = 0;
+            // Set the length of the string and its null-byte.
+            string.Terminate(Length() + other.Length());
 
-                    return string;
-                }
-                else
-                {
-                    // Just return a copy of this string since the other string doesn't have any data.
-                    return String(Data, Length);
-                }
-            }
-            else
-            {
-                // If the other string has data..
-                if(other.Data)
-                {
-                    // Just return a copy of the other string since this string doesn't have any data.
-                    return String(other.Data, other.Length);
-                }
-                else
-                {
-                    // Return an empty string since neither strings contain data.
-                    return String();
-                }
-            }
+            return string;
         };
 
         // Methods
 
+        // Check if the string is stored inline rather than on the heap.
+        Bool Inlined() const
+        {
+            return Internal[Inline + 1] != Allocated;
+        };
+
+        // The characters of the string, followed by the null-byte. Never null, even for empty strings.
+        Byte* Data()
+        {
+            return Inlined() ? Internal : External.Data;
+        };
+        // The characters of the string, followed by the null-byte. Never null, even for empty strings.
+        const Byte* Data() const
+        {
+            return Inlined() ? Internal : External.Data;
+        };
+
+        // The number of characters in the string (not including the null-byte). Always less than or equal to Capacity().
+        Int Length() const
+        {
+            return Inlined() ? Int(Internal[Inline + 1]) : External.Length;
+        };
+
+        // The number of characters the string can hold without reallocating (not including the null-byte).
+        Int Capacity() const
+        {
+            return Inlined() ? Inline : External.Capacity;
+        };
+
         // The size of the string in bytes (including the null-delimiter).
         Int Size() const
         {
-            // Number of character plus the null-delimiter if the string is allocated
-            return Data ? Length + 1 : 0;
+            // Number of character plus the null-delimiter if the string has any characters
+            return Length() ? Length() + 1 : 0;
         };
 
         // Release the contents and memory allocated by the string.
         Void Release()
         {
-            if(Data) { Memory::Free(Data); Data = nullptr; }
-            Length = 0;
-            Capacity = 0;
+            if(!Inlined()) { Memory::Free(External.Data); }
+            // -- //
+            Memory::Zero(Internal, sizeof(Internal));
         };
 
         // Reserve capacity for the string. Null-byte is implicit and shouldn't be reserved.
-        // Does nothing if size is zero. Does nothing if size is equal to or less than Capacity.
+        // Does nothing if size is equal to or less than Capacity(), which is never less than Inline.
         Void Reserve(Int size)
         {
             // Debug check
             Assert(size >= 0, "Attempting to reserve an invalid number of characters.");
 
-            // Only reallocate if size is greater than zero and less than the string's current capacity.
-            if((size > 0) && (size > Capacity))
+            // Only reallocate if size is greater than the string's current capacity.
+            if(size > Capacity())
             {
-                // Reallocate the string.
-                Data = (Byte*)Memory::Resize(Data, size + 1);
+                if(Inlined())
+                {
+                    // Helper
+                    Int length = Length();
+                    // Move the inline characters (and the null-byte) out to the heap.
+                    Byte* data = (Byte*)Memory::Request(size + 1);
+                    Memory::Copy(data, Internal, length + 1);
+                    // -- //
+                    External.Data = data;
+                    External.Length = length;
+                    Internal[Inline + 1] = Allocated;
+                }
+                else
+                {
+                    // Reallocate the string.
+                    External.Data = (Byte*)Memory::Resize(External.Data, size + 1);
+                }
 
                 // Set the new capacity.
-                Capacity = size;
+                External.Capacity = size;
             }
         };
 
-        // Iterate through the string to locate a character. Returns Length if a match isn't found.
+        // Iterate through the string to locate a character. Returns Length() if a match isn't found.
         // An optional offset can be applied to specify the character index to start the search from.
         Int Find(Byte character, Int offset = 0) const
         {
-            // Debug check
-            Assert(offset >= 0, "Cannot begin string search using a negative offset.");
+            return StringView(*this).Find(character, offset);
+        };
 
-            // Loop through the characters, starting at offset.
-            for(; offset < Length; offset++)
-            {
-                // Return the index if the characters match.
-                if(Data[offset] == character) { return offset; }
-            }
+        // Locate the first occurrence of a substring. Returns Length() if a match isn't found.
+        // An optional offset can be applied to specify the character index to start the search from.
+        Int Find(const StringView& substring, Int offset = 0) const
+        {
+            return StringView(*this).Find(substring, offset);
+        };
 
-            // Return Length to signify a match wasn't found (offset should be equal to Length here).
-            return offset;
+        // Locate the first character that's contained in a set of characters. Returns Length() if a match isn't found.
+        // An optional offset can be applied to specify the character index to start the search from.
+        Int FindAny(const StringView& set, Int offset = 0) const
+        {
+            return StringView(*this).FindAny(set, offset);
         };
 
-        // Iterate through the string in reverse to locate a character. Returns Length if a match isn't found.
-        // The offset is expected to be a character index, rather than a relative offset from the end of the string.
-        // For example, specifying an offset of 2 means starting the search from Data[2], moving backwards from there.
+        // Iterate through the string in reverse to locate a character, starting from the character at offset. Returns -1 if a match isn't found.
         Int rFind(Byte character, Int offset) const
         {
-            // Loop through the characters in reverse, starting at offset.
-            for(; offset >= 0; offset--)
-            {
-                // Return the index if the characters match.
-                if(Data[offset] == character) { return offset; }
-            }
-
-            // Return Length to signify a match wasn't found (offset should be equal to Length here).
-            return offset;
+            return StringView(*this).rFind(character, offset);
         };
 
-        // Iterate through the string in reverse to locate a character. Returns Length if a match isn't found.
+        // Iterate through the string in reverse to locate a character. Returns -1 if a match isn't found.
         Int rFind(Byte character) const
         {
-            // Simply a helper for calling the offset-based rFind but starting at the end of the string.
-            return rFind(character, Length - 1);
-        }
+            return StringView(*this).rFind(character);
+        };
+
+    private:
+        // Internal methods
+
+        // Reserve capacity for appending, at least doubling the capacity so that repeated appends don't reallocate every time.
+        Void Grow(Int size)
+        {
+            if(size > Capacity()) { Reserve((size > Capacity() * 2) ? size : Capacity() * 2); }
+        };
+
+        // Set the length of the string and write the null-byte after its last character. The capacity must already be reserved.
+        Void Terminate(Int length)
+        {
+            if(Inlined()) { Internal[Inline + 1] = Byte(length); }
+            else { External.Length = length; }
+            // -- //
+            Data()[length] = 0;
+        };
     };
 }
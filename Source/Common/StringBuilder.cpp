@@ -0,0 +1,50 @@
+/*
+-------------------------------------------------------------------------------
+    Filename: Common/StringBuilder.cpp
+-------------------------------------------------------------------------------
+*/
+
+// Includes
+#include "..\Common\StringBuilder.hpp"
+// -- //
+#include "..\Common\Number.hpp"
+
+// --------------------------------------------------------------------------------------------
+namespace R2D
+{
+    // ----------------------------------------------------------------------------------------
+    StringBuilder& StringBuilder::Append(Long number)
+    {
+        // Format the number on the stack first, so only its actual length is reserved.
+        Byte digits[Number::Capacity];
+        // -- //
+        return Append(StringView(digits, Number::Format(number, digits)));
+    };
+
+    // ----------------------------------------------------------------------------------------
+    StringBuilder& StringBuilder::Append(uLong number)
+    {
+        // Format the number on the stack first, so only its actual length is reserved.
+        Byte digits[Number::Capacity];
+        // -- //
+        return Append(StringView(digits, Number::Format(number, digits)));
+    };
+
+    // ----------------------------------------------------------------------------------------
+    StringBuilder& StringBuilder::Append(Float number)
+    {
+        // Format the number on the stack first, so only its actual length is reserved. Uses the shortest digits that read back the same value.
+        Byte digits[Number::Capacity];
+        // -- //
+        return Append(StringView(digits, Number::Format(number, digits)));
+    };
+
+    // ----------------------------------------------------------------------------------------
+    StringBuilder& StringBuilder::Append(Double number)
+    {
+        // Format the number on the stack first, so only its actual length is reserved. Uses the shortest digits that read back the same value.
+        Byte digits[Number::Capacity];
+        // -- //
+        return Append(StringView(digits, Number::Format(number, digits)));
+    };
+}
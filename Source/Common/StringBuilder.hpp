@@ -0,0 +1,124 @@
+/*
+-------------------------------------------------------------------------------
+    Filename: Common/StringBuilder.hpp
+-------------------------------------------------------------------------------
+*/
+
+// Header guard
+#pragma once
+// Includes
+#include "..\Common.hpp"
+#include "..\Common\Memory.hpp"
+#include "..\Common\String.hpp"
+#include "..\Common\StringView.hpp"
+
+// --------------------------------------------------------------------------------------------
+namespace R2D
+{
+    // ----------------------------------------------------------------------------------------
+    // Helper for assembling a string out of many pieces, e.g. paths. Appending views, characters and numbers never creates
+    // intermediate strings, and the capacity grows geometrically so repeated appends are amortized constant time.
+    // Short results stay in the string's inline storage and never allocate at all.
+    class StringBuilder
+    {
+    private:
+        // Members
+
+        // The string being built.
+        String Buffer;
+
+    public:
+        // Constructors
+
+        // Default constructor.
+        StringBuilder() : Buffer() {};
+        // Capacity constructor. Reserves room for the specified number of characters up front.
+        explicit StringBuilder(Int capacity) : Buffer() { Buffer.Reserve(capacity); };
+        // Copy constructor.
+        StringBuilder(const StringBuilder& other) = delete;
+        // Move constructor.
+        StringBuilder(StringBuilder&& other) : Buffer(R2D::Move(other.Buffer)) {};
+
+        // Methods
+
+        // The number of characters appended so far.
+        Int Length() const
+        {
+            return Buffer.Length();
+        };
+
+        // View the characters appended so far. The view is invalidated by the next append.
+        StringView View() const
+        {
+            return Buffer;
+        };
+
+        // Ensure there's room for at least the specified number of additional characters.
+        Void Reserve(Int count)
+        {
+            Buffer.Grow(Buffer.Length() + count);
+        };
+
+        // Remove the appended characters, keeping the capacity.
+        Void Clear()
+        {
+            Buffer.Terminate(0);
+        };
+
+        // Append the characters referenced by a view.
+        StringBuilder& Append(const StringView& view)
+        {
+            // Helpers
+            Int length = Buffer.Length();
+            Bool aliased = (view.Data() >= Buffer.Data()) && (view.Data() < Buffer.Data() + length);
+            Int offset = aliased ? Int(view.Data() - Buffer.Data()) : 0;
+
+            // Make room first. Growing may move the string, so a view of its own characters is copied from its offset afterwards.
+            Reserve(view.Length());
+            // -- //
+            const Byte* source = aliased ? Buffer.Data() + offset : view.Data();
+
+            // Copy the characters to the end of the string.
+            Memory::Copy(Buffer.Data() + length, source, view.Length());
+            Buffer.Terminate(length + view.Length());
+            // -- //
+            return *this;
+        };
+
+        // Append a string literal.
+        template <size_t size> StringBuilder& Append(const char(&string)[size])
+        {
+            return Append(StringView(string));
+        };
+
+        // Append a character.
+        StringBuilder& Append(Byte character)
+        {
+            // Helper
+            Int length = Buffer.Length();
+
+            // Write the character at the end of the string.
+            Reserve(1);
+            Buffer.Data()[length] = character;
+            Buffer.Terminate(length + 1);
+            // -- //
+            return *this;
+        };
+
+        // Append an integer in decimal.
+        StringBuilder& Append(Int number) { return Append(Long(number)); };
+        StringBuilder& Append(uInt number) { return Append(uLong(number)); };
+        StringBuilder& Append(Long number);
+        StringBuilder& Append(uLong number);
+
+        // Append a floating-point number, using as many digits as needed to read back the same value.
+        StringBuilder& Append(Float number);
+        StringBuilder& Append(Double number);
+
+        // Materialize the result, leaving the builder empty.
+        String Build()
+        {
+            return R2D::Move(Buffer);
+        };
+    };
+}
@@ -0,0 +1,209 @@
+/*
+-------------------------------------------------------------------------------
+    Filename: Common/StringView.cpp
+-------------------------------------------------------------------------------
+*/
+
+// Includes
+#include "..\Common\StringView.hpp"
+// -- //
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+#if defined(_M_X64) || defined(__SSE2__)
+#define R2D_SSE2
+#include <emmintrin.h>
+#endif
+
+// --------------------------------------------------------------------------------------------
+namespace R2D
+{
+    // ----------------------------------------------------------------------------------------
+    Int StringView::Find(Byte character, Int offset) const
+    {
+        // Debug check
+        Assert(offset >= 0, "Cannot begin string search using a negative offset.");
+
+        // Compare whole blocks of characters at once while they fit, then finish the remainder one character at a time.
+        #if defined(__AVX2__)
+        {
+            __m256i needle = _mm256_set1_epi8(character);
+            // -- //
+            for(; offset + 32 <= Count; offset += 32)
+            {
+                uInt mask = _mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(Pointer + offset)), needle));
+                // -- //
+                if(mask) { return offset + BitScanForward(mask); }
+            }
+        }
+        #endif
+        #if defined(R2D_SSE2)
+        {
+            __m128i needle = _mm_set1_epi8(character);
+            // -- //
+            for(; offset + 16 <= Count; offset += 16)
+            {
+                uInt mask = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(Pointer + offset)), needle));
+                // -- //
+                if(mask) { return offset + BitScanForward(mask); }
+            }
+        }
+        #endif
+        // -- //
+        for(; offset < Count; offset++)
+        {
+            if(Pointer[offset] == character) { return offset; }
+        }
+
+        // Return Length() to signify a match wasn't found.
+        return Count;
+    };
+
+    // ----------------------------------------------------------------------------------------
+    Int StringView::Find(const StringView& substring, Int offset) const
+    {
+        // Debug check
+        Assert(offset >= 0, "Cannot begin string search using a negative offset.");
+
+        // Helpers
+        const Byte* needle = substring.Pointer;
+        Int length = substring.Count;
+        Int last = Count - length;
+
+        // Trivial cases.
+        if(length == 0) { return (offset < Count) ? offset : Count; }
+        if(offset > last) { return Count; }
+        if(length == 1) { return Find(needle[0], offset); }
+
+        // Find the positions where both the first and the last characters of the substring match, and only compare
+        // the characters in between at those positions. This filters out nearly every mismatch without a full comparison.
+        #if defined(__AVX2__)
+        {
+            __m256i first = _mm256_set1_epi8(needle[0]);
+            __m256i ending = _mm256_set1_epi8(needle[length - 1]);
+            // -- //
+            for(; offset + 32 <= last + 1; offset += 32)
+            {
+                __m256i a = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(Pointer + offset)), first);
+                __m256i b = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(Pointer + offset + length - 1)), ending);
+                // -- //
+                for(uInt mask = _mm256_movemask_epi8(_mm256_and_si256(a, b)); mask; mask &= mask - 1)
+                {
+                    Int index = offset + BitScanForward(mask);
+                    // -- //
+                    if(Memory::Compare(Pointer + index + 1, needle + 1, length - 2)) { return index; }
+                }
+            }
+        }
+        #endif
+        #if defined(R2D_SSE2)
+        {
+            __m128i first = _mm_set1_epi8(needle[0]);
+            __m128i ending = _mm_set1_epi8(needle[length - 1]);
+            // -- //
+            for(; offset + 16 <= last + 1; offset += 16)
+            {
+                __m128i a = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(Pointer + offset)), first);
+                __m128i b = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(Pointer + offset + length - 1)), ending);
+                // -- //
+                for(uInt mask = _mm_movemask_epi8(_mm_and_si128(a, b)); mask; mask &= mask - 1)
+                {
+                    Int index = offset + BitScanForward(mask);
+                    // -- //
+                    if(Memory::Compare(Pointer + index + 1, needle + 1, length - 2)) { return index; }
+                }
+            }
+        }
+        #endif
+        // -- //
+        for(; offset <= last; offset++)
+        {
+            if((Pointer[offset] == needle[0]) && Memory::Compare(Pointer + offset + 1, needle + 1, length - 1)) { return offset; }
+        }
+
+        // Return Length() to signify a match wasn't found.
+        return Count;
+    };
+
+    // ----------------------------------------------------------------------------------------
+    Int StringView::FindAny(const StringView& set, Int offset) const
+    {
+        // Debug check
+        Assert(offset >= 0, "Cannot begin string search using a negative offset.");
+
+        // Small sets, like separators or whitespace, are compared against every character in a block at once.
+        #if defined(R2D_SSE2)
+        if(set.Count <= 8)
+        {
+            __m128i needles[8];
+            for(Int i = 0; i < set.Count; i++) { needles[i] = _mm_set1_epi8(set.Pointer[i]); }
+            // -- //
+            for(; offset + 16 <= Count; offset += 16)
+            {
+                __m128i block = _mm_loadu_si128((const __m128i*)(Pointer + offset));
+                __m128i matches = _mm_setzero_si128();
+                // -- //
+                for(Int i = 0; i < set.Count; i++) { matches = _mm_or_si128(matches, _mm_cmpeq_epi8(block, needles[i])); }
+                // -- //
+                uInt mask = _mm_movemask_epi8(matches);
+                if(mask) { return offset + BitScanForward(mask); }
+            }
+        }
+        #endif
+
+        // Otherwise (and for the remainder) look each character up in a bit table of the set.
+        uLong table[4] = { 0, 0, 0, 0 };
+        for(Int i = 0; i < set.Count; i++) { uByte character = set.Pointer[i]; table[character >> 6] |= 1ULL << (character & 63); }
+        // -- //
+        for(; offset < Count; offset++)
+        {
+            uByte character = Pointer[offset];
+            // -- //
+            if(table[character >> 6] & (1ULL << (character & 63))) { return offset; }
+        }
+
+        // Return Length() to signify a match wasn't found.
+        return Count;
+    };
+
+    // ----------------------------------------------------------------------------------------
+    Int StringView::rFind(Byte character, Int offset) const
+    {
+        // Debug check
+        Assert(offset < Count, "Cannot begin string search past the end of the string.");
+
+        // Compare whole blocks of characters ending at offset while they fit, then finish the remainder one character at a time.
+        #if defined(__AVX2__)
+        {
+            __m256i needle = _mm256_set1_epi8(character);
+            // -- //
+            for(; offset >= 31; offset -= 32)
+            {
+                uInt mask = _mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(Pointer + offset - 31)), needle));
+                // -- //
+                if(mask) { return offset - 31 + BitScanReverse(mask); }
+            }
+        }
+        #endif
+        #if defined(R2D_SSE2)
+        {
+            __m128i needle = _mm_set1_epi8(character);
+            // -- //
+            for(; offset >= 15; offset -= 16)
+            {
+                uInt mask = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(Pointer + offset - 15)), needle));
+                // -- //
+                if(mask) { return offset - 15 + BitScanReverse(mask); }
+            }
+        }
+        #endif
+        // -- //
+        for(; offset >= 0; offset--)
+        {
+            if(Pointer[offset] == character) { return offset; }
+        }
+
+        // Return -1 to signify a match wasn't found.
+        return -1;
+    };
+}
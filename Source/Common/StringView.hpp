@@ -0,0 +1,110 @@
+/*
+-------------------------------------------------------------------------------
+    Filename: Common/StringView.hpp
+-------------------------------------------------------------------------------
+*/
+
+// Header guard
+#pragma once
+// Includes
+#include "..\Common.hpp"
+#include "..\Common\Memory.hpp"
+
+// --------------------------------------------------------------------------------------------
+namespace R2D
+{
+    // ----------------------------------------------------------------------------------------
+    // Non-owning reference to a range of characters, e.g. a substring of a String or a token inside a loaded file.
+    // Views aren't null-terminated, and the characters they reference must outlive them.
+    // Searches are vectorized with AVX2 when compiled with /arch:AVX2, otherwise with SSE2, and fall back to scalar loops elsewhere.
+    class StringView
+    {
+    private:
+        // Members
+
+        // The first character in the view.
+        const Byte* Pointer;
+        // The number of characters in the view.
+        Int Count;
+
+    public:
+        // Constructors
+
+        // Default constructor.
+        constexpr StringView() : Pointer(nullptr), Count(0) {};
+        // C-string pointer constructor. Length is the number of characters to reference.
+        constexpr StringView(const char* string, Int length) : Pointer(string), Count(length) {};
+        // C-string constructor. References the string without its null-byte.
+        template <size_t size> constexpr StringView(const char(&string)[size]) : Pointer(string), Count(size - 1) {};
+
+        // Operators
+
+        // Array access operator.
+        const Byte& operator [] (Int index) const
+        {
+            // Debug checks
+            Assert(index >= 0, "Tried to access characters with a negative index.");
+            Assert(index < Count, "Tried to access characters past the end of the view.");
+
+            return Pointer[index];
+        };
+
+        // Equality operators. Views are equal if their characters are equal, regardless of where they point.
+        Bool operator == (const StringView& other) const { return (Count == other.Count) && Memory::Compare(Pointer, other.Pointer, Count); }
+        Bool operator != (const StringView& other) const { return !(*this == other); }
+
+        // Methods
+
+        // The characters in the view. Not null-terminated.
+        const Byte* Data() const
+        {
+            return Pointer;
+        };
+
+        // The number of characters in the view.
+        Int Length() const
+        {
+            return Count;
+        };
+
+        // Locate the first occurrence of a character, starting from the character at offset. Returns Length() if a match isn't found.
+        Int Find(Byte character, Int offset = 0) const;
+        // Locate the first occurrence of a substring, starting from the character at offset. Returns Length() if a match isn't found.
+        Int Find(const StringView& substring, Int offset = 0) const;
+        // Locate the first character that's contained in a set of characters, starting from the character at offset.
+        // Returns Length() if a match isn't found.
+        Int FindAny(const StringView& set, Int offset = 0) const;
+
+        // Locate the last occurrence of a character, searching backwards from the character at offset. Returns -1 if a match isn't found.
+        Int rFind(Byte character, Int offset) const;
+        // Locate the last occurrence of a character. Returns -1 if a match isn't found.
+        Int rFind(Byte character) const
+        {
+            return rFind(character, Count - 1);
+        };
+
+        // Create a view of a range of the view's characters. The range is clamped to the end of the view.
+        StringView Slice(Int offset, Int length) const
+        {
+            // Debug check
+            Assert((offset >= 0) && (offset <= Count) && (length >= 0), "Cannot slice a view using an invalid range.");
+
+            return StringView(Pointer + offset, (length < Count - offset) ? length : Count - offset);
+        };
+
+        // Split the view at the first occurrence of a delimiter. Returns the characters before the delimiter and advances the view past it.
+        // If the delimiter isn't found, the whole view is returned and the view is left empty.
+        StringView Split(Byte delimiter)
+        {
+            Int index = Find(delimiter);
+            StringView token(Pointer, index);
+
+            // Skip the token and the delimiter.
+            index += (index < Count) ? 1 : 0;
+            Pointer += index;
+            Count -= index;
+            // -- //
+            return token;
+        };
+    };
+}
@@ -0,0 +1,436 @@
+/*
+-------------------------------------------------------------------------------
+    Filename: Common/Watcher.cpp
+-------------------------------------------------------------------------------
+*/
+
+// Includes
+#include "..\Common\Watcher.hpp"
+// -- //
+#include "..\Common\Directory.hpp"
+#include "..\Common\Hash.hpp"
+#include "..\Common\Map.hpp"
+// -- //
+#include <chrono>
+#if defined(_WIN32)
+#include "..\Common\Windows.hpp"
+#elif defined(__linux__)
+#include <errno.h>
+#include <string.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// --------------------------------------------------------------------------------------------
+namespace R2D
+{
+    // ----------------------------------------------------------------------------------------
+    // The state of a watcher.
+    struct WatcherState
+    {
+        #if defined(_WIN32)
+        // The watched directory, opened for overlapped change notifications.
+        HANDLE Folder = INVALID_HANDLE_VALUE;
+        // The pending notification request.
+        OVERLAPPED Overlapped = {};
+        // The notifications are written here. 64 KiB is the most ReadDirectoryChangesW() accepts for network drives.
+        DWORD Buffer[16384];
+        #elif defined(__linux__)
+        // The inotify instance.
+        int Notify = -1;
+        // The path of the folder each watch descriptor is watching, relative to the root and indexed by the descriptor.
+        Array<String> Folders;
+        #endif
+        // The hashes of the paths in the watcher's changes, for coalescing them.
+        Array<uInt> Hashes;
+        // The index of the first change with each of those hashes, so a rescan reporting a whole tree doesn't compare every change
+        // against every other one.
+        Map<uInt, Int> Reported;
+
+        // Set when the tree is rescanned for changes, because notifications aren't available.
+        Bool Polling = false;
+        // The last scan of the tree when polling.
+        Directory::Listing Snapshot;
+        // The time of the last scan when polling.
+        std::chrono::steady_clock::time_point Last;
+    };
+
+    // ----------------------------------------------------------------------------------------
+    // Add a changed file to the watcher's changes, unless it's already among them.
+    static Void WatcherReport(Watcher& watcher, const StringView& path)
+    {
+        WatcherState* state = (WatcherState*)watcher.Handle;
+        // Helper
+        uInt hash = Hash::FNV32(path);
+
+        // Coalesce repeated changes to the same file. Only the changes from the first one with the same hash on are compared.
+        Int* first = state->Reported.Find(hash);
+        // -- //
+        for(Int i = first ? *first : state->Hashes.Count; i < state->Hashes.Count; i++)
+        {
+            // -- //
+            if(state->Hashes[i] == hash && StringView(watcher.Changes[i]) == path) { return; }
+        }
+
+        // Keep the map at most half full, since it doesn't grow by itself.
+        if(!first)
+        {
+            if(state->Reported.Count * 2 >= state->Reported.Capacity) { state->Reported.Expand(state->Reported.Capacity ? state->Reported.Capacity : 64); }
+            state->Reported.Add(hash, watcher.Changes.Count);
+        }
+
+        // Grow the arrays geometrically.
+        if(watcher.Changes.Count == watcher.Changes.Capacity)
+        {
+            Int count = watcher.Changes.Capacity ? watcher.Changes.Capacity : 16;
+            // -- //
+            watcher.Changes.Reserve(count);
+            state->Hashes.Reserve(count);
+        }
+
+        // -- //
+        watcher.Changes.Append(path);
+        state->Hashes.Append(hash);
+    };
+
+    // ----------------------------------------------------------------------------------------
+    // Scan the tree and report the files that weren't in the snapshot or whose size or modification time differ, then keep the scan
+    // as the next snapshot. Without a snapshot, every file in the tree is reported.
+    static Void WatcherRescan(Watcher& watcher)
+    {
+        WatcherState* state = (WatcherState*)watcher.Handle;
+        Directory::Listing& previous = state->Snapshot;
+
+        Directory::Listing listing;
+        // Scan the tree.
+        Directory::Scan(watcher.Root, listing);
+
+        Map<uInt, Int> index;
+        // Index the snapshot's files by the hashes of their paths.
+        if(previous.Entries.Count)
+        {
+            // Keep the map at most half full.
+            Int capacity = 64;
+            while(capacity < previous.Entries.Count * 2) { capacity <<= 1; }
+            index.Expand(capacity);
+            // -- //
+            for(Int i = 0; i < previous.Entries.Count; i++)
+            {
+                // Helper
+                uInt hash = Hash::FNV32(previous.Path(i));
+                // Files whose paths share a hash are simply always reported as changed.
+                if(previous.Entries[i].Type == Directory::Kind::File && !index.Find(hash)) { index.Add(hash, i); }
+            }
+        }
+
+        // Compare the files.
+        for(Int i = 0; i < listing.Entries.Count; i++)
+        {
+            // Helper
+            const Directory::Entry& entry = listing.Entries[i];
+            // -- //
+            if(entry.Type != Directory::Kind::File) { continue; }
+
+            // Look the file up in the snapshot.
+            StringView path = listing.Path(i);
+            Int* match = index.Find(Hash::FNV32(path));
+            // -- //
+            if(match)
+            {
+                // Helper
+                const Directory::Entry& old = previous.Entries[*match];
+                // -- //
+                if(previous.Path(*match) == path && old.Size == entry.Size && old.Modified == entry.Modified) { continue; }
+            }
+
+            // The file is new or has changed.
+            WatcherReport(watcher, path);
+        }
+
+        // Keep the scan for the next comparison.
+        previous.Entries = Move(listing.Entries);
+        previous.Text = Move(listing.Text);
+        state->Last = std::chrono::steady_clock::now();
+    };
+
+    #if defined(_WIN32)
+    // ----------------------------------------------------------------------------------------
+    // Request the next batch of change notifications.
+    static Bool WatcherRequest(WatcherState* state)
+    {
+        DWORD filter = FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_DIR_NAME | FILE_NOTIFY_CHANGE_SIZE | FILE_NOTIFY_CHANGE_LAST_WRITE;
+        // -- //
+        return ReadDirectoryChangesW(state->Folder, state->Buffer, sizeof(state->Buffer), TRUE, filter, nullptr, &state->Overlapped, nullptr);
+    };
+    #elif defined(__linux__)
+    // ----------------------------------------------------------------------------------------
+    // Watch a folder, given its path relative to the root. Returns false if the folder couldn't be watched.
+    static Bool WatcherAdd(Watcher& watcher, const StringView& folder)
+    {
+        WatcherState* state = (WatcherState*)watcher.Handle;
+        // Helper
+        uint32_t mask = IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE | IN_ONLYDIR;
+
+        // Add the watch.
+        Path path = watcher.Root / folder;
+        int descriptor = inotify_add_watch(state->Notify, path.Data(), mask);
+        // -- //
+        if(descriptor < 0) { return false; }
+
+        // Watch descriptors are small and handed out in increasing order, so they directly index the folders.
+        if(descriptor >= state->Folders.Capacity)
+        {
+            Int count = state->Folders.Capacity ? state->Folders.Capacity : 64;
+            while(state->Folders.Capacity + count <= descriptor) { count <<= 1; }
+            // -- //
+            state->Folders.Reserve(count);
+        }
+        // -- //
+        while(state->Folders.Count <= descriptor) { state->Folders.Append(); }
+        // -- //
+        state->Folders[descriptor] = String(folder);
+        return true;
+    };
+
+    // ----------------------------------------------------------------------------------------
+    // Watch the subfolders of a folder given its path relative to the root, and report the files in them. Used for the whole tree when
+    // events were lost, and for folders created (or moved in) since they were watched, whose contents might predate their watches.
+    static Bool WatcherCatchUp(Watcher& watcher, const StringView& folder)
+    {
+        Directory::Listing listing;
+        // Scan the folder.
+        Directory::Scan(watcher.Root / folder, listing);
+
+        // The listing's paths are relative to the folder.
+        Path path;
+        // -- //
+        for(Int i = 0; i < listing.Entries.Count; i++)
+        {
+            path.Clear();
+            path.Join(folder);
+            path.Join(listing.Path(i));
+
+            // Watch the subfolders and report the files.
+            if(listing.Entries[i].Type == Directory::Kind::Folder) { if(!WatcherAdd(watcher, path)) { return false; } }
+            else if(listing.Entries[i].Type == Directory::Kind::File) { WatcherReport(watcher, path); }
+        }
+        // -- //
+        return true;
+    };
+    #endif
+
+    // ----------------------------------------------------------------------------------------
+    Void Watcher::Open(const StringView& directory)
+    {
+        // Debug check
+        Assert(!Handle, "Attempting to open a watcher that is already open.");
+
+        // Resolve the path; Relative paths are joined onto the working directory.
+        Root.Clear();
+        if(Directory::Working) { Root = *Directory::Working; }
+        Root.Join(directory);
+
+        // -- //
+        WatcherState* state = Memory::Request<WatcherState>();
+        Handle = state;
+
+        #if defined(_WIN32)
+        // Open the directory for overlapped change notifications.
+        std::wstring wpath = widen(Root);
+        state->Folder = CreateFileW(wpath.c_str(), FILE_LIST_DIRECTORY, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING,
+                                    FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, nullptr);
+        state->Overlapped.hEvent = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+
+        // Watching the subtree covers folders created later as well.
+        state->Polling = (state->Folder == INVALID_HANDLE_VALUE) || !state->Overlapped.hEvent || !WatcherRequest(state);
+        #elif defined(__linux__)
+        // Watch the root and every folder under it. Watches are limited per user, so large trees may have to be polled.
+        state->Notify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        state->Polling = (state->Notify < 0) || !WatcherAdd(*this, StringView("", 0)) || !WatcherCatchUp(*this, StringView("", 0));
+        // -- //
+        if(state->Polling && state->Notify >= 0) { close(state->Notify); state->Notify = -1; }
+        #else
+        state->Polling = true;
+        #endif
+
+        // Fall back to polling, starting from a scan of the tree as it is.
+        if(state->Polling) { WatcherRescan(*this); }
+
+        // Files already in the tree aren't changes.
+        for(Int i = 0; i < Changes.Count; i++) { Changes[i].~String(); }
+        Changes.Count = 0;
+        state->Hashes.Count = 0;
+        state->Reported.Release();
+    };
+
+    // ----------------------------------------------------------------------------------------
+    Void Watcher::Close()
+    {
+        WatcherState* state = (WatcherState*)Handle;
+        // -- //
+        if(state)
+        {
+            #if defined(_WIN32)
+            // Cancel the pending request and wait for it to stop using the buffer.
+            if(state->Folder != INVALID_HANDLE_VALUE)
+            {
+                DWORD bytes;
+                if(CancelIoEx(state->Folder, &state->Overlapped) || GetLastError() != ERROR_NOT_FOUND) { GetOverlappedResult(state->Folder, &state->Overlapped, &bytes, TRUE); }
+                CloseHandle(state->Folder);
+            }
+            // -- //
+            if(state->Overlapped.hEvent) { CloseHandle(state->Overlapped.hEvent); }
+            #elif defined(__linux__)
+            // Closing the instance removes its watches.
+            if(state->Notify >= 0) { close(state->Notify); }
+            // -- //
+            for(Int i = 0; i < state->Folders.Count; i++) { state->Folders[i].~String(); }
+            state->Folders.Release();
+            #endif
+
+            // Release the state.
+            state->Hashes.Release();
+            state->Reported.Release();
+            state->Snapshot.Release();
+            state->~WatcherState();
+            Memory::Free(state);
+            Handle = nullptr;
+        }
+
+        // Release the changes.
+        for(Int i = 0; i < Changes.Count; i++) { Changes[i].~String(); }
+        Changes.Release();
+        Root.Release();
+    };
+
+    // ----------------------------------------------------------------------------------------
+    Int Watcher::Poll()
+    {
+        WatcherState* state = (WatcherState*)Handle;
+
+        // Forget the previous changes.
+        for(Int i = 0; i < Changes.Count; i++) { Changes[i].~String(); }
+        Changes.Count = 0;
+        // -- //
+        if(!state) { return 0; }
+        state->Hashes.Count = 0;
+        if(state->Reported.Count) { state->Reported.Release(); }
+
+        // Rescan the tree once the interval has passed.
+        if(state->Polling)
+        {
+            if(std::chrono::steady_clock::now() - state->Last >= std::chrono::nanoseconds(Interval)) { WatcherRescan(*this); }
+            // -- //
+            return Changes.Count;
+        }
+
+        #if defined(_WIN32)
+        DWORD bytes;
+        // Drain the completed requests.
+        while(GetOverlappedResult(state->Folder, &state->Overlapped, &bytes, FALSE))
+        {
+            // Nothing is returned when the buffer overflowed and notifications were lost; Every file has to be considered changed.
+            if(!bytes)
+            {
+                Directory::Listing listing;
+                // -- //
+                Directory::Scan(Root, listing);
+                for(Int i = 0; i < listing.Entries.Count; i++) { if(listing.Entries[i].Type == Directory::Kind::File) { WatcherReport(*this, listing.Path(i)); } }
+            }
+
+            // Iterate over the notifications.
+            Byte* record = (Byte*)state->Buffer;
+            // -- //
+            while(bytes)
+            {
+                FILE_NOTIFY_INFORMATION* notification = (FILE_NOTIFY_INFORMATION*)record;
+                // -- //
+                if(notification->Action == FILE_ACTION_ADDED || notification->Action == FILE_ACTION_MODIFIED || notification->Action == FILE_ACTION_RENAMED_NEW_NAME)
+                {
+                    // Convert the relative path to UTF-8 and POSIX separators.
+                    String path = narrow(std::wstring(notification->FileName, notification->FileNameLength / sizeof(WCHAR)));
+                    for(Int i = 0; i < path.Length(); i++) { if(path[i] == '\\') { path[i] = '/'; } }
+
+                    // Folders are reported as modified when their contents change, but only files are of interest.
+                    std::wstring wpath = widen(Root / path);
+                    DWORD attributes = GetFileAttributesW(wpath.c_str());
+                    // -- //
+                    if(attributes != INVALID_FILE_ATTRIBUTES && !(attributes & FILE_ATTRIBUTE_DIRECTORY)) { WatcherReport(*this, path); }
+                }
+
+                // -- //
+                if(!notification->NextEntryOffset) { break; }
+                record += notification->NextEntryOffset;
+            }
+
+            // Request the next batch, polling from now on if that's no longer possible.
+            if(!WatcherRequest(state)) { break; }
+        }
+
+        // Poll from now on if notifications stopped coming, for example because the directory was removed.
+        if(GetLastError() != ERROR_IO_INCOMPLETE) { state->Polling = true; WatcherRescan(*this); }
+        #elif defined(__linux__)
+        // Events are read whole, so the buffer has room for at least one with the longest name.
+        alignas(inotify_event) Byte buffer[16384];
+        Bool lost = false;
+
+        // Drain the queued events.
+        while(true)
+        {
+            ssize_t bytes = read(state->Notify, buffer, sizeof(buffer));
+            // -- //
+            if(bytes < 0 && errno == EINTR) { continue; }
+            if(bytes <= 0) { break; }
+
+            // Iterate over the events.
+            for(ssize_t offset = 0; offset < bytes;)
+            {
+                inotify_event* event = (inotify_event*)(buffer + offset);
+                offset += sizeof(inotify_event) + event->len;
+
+                // The queue overflowed and events were lost.
+                if(event->mask & IN_Q_OVERFLOW) { lost = true; continue; }
+                // -- //
+                if(!event->len || event->wd < 0 || event->wd >= state->Folders.Count) { continue; }
+
+                // Build the object's path relative to the root.
+                String path(state->Folders[event->wd]);
+                // -- //
+                if(path.Length()) { path += '/'; }
+                path += StringView(event->name, Int(strlen(event->name)));
+
+                // Watch new folders, and report what's already in them.
+                if(event->mask & IN_ISDIR)
+                {
+                    // -- //
+                    if((event->mask & (IN_CREATE | IN_MOVED_TO)) && (!WatcherAdd(*this, path) || !WatcherCatchUp(*this, path))) { lost = true; }
+                }
+                // Report files once they've been written and closed, or moved into place.
+                else if(event->mask & (IN_CLOSE_WRITE | IN_MOVED_TO)) { WatcherReport(*this, path); }
+            }
+        }
+
+        // When events were lost, rewatch the tree and consider every file changed.
+        if(lost && !WatcherCatchUp(*this, StringView("", 0)))
+        {
+            // Poll from now on if the folders can't all be watched.
+            state->Polling = true;
+            WatcherRescan(*this);
+        }
+
+        // Drop the files removed again before the poll, such as the temporary files some editors save through. This shifts the changes
+        // the map indexes, but nothing is reported again before the next poll resets it.
+        for(Int i = Changes.Count - 1; i >= 0; i--)
+        {
+            Path path = Root / Changes[i];
+            struct stat status;
+            // -- //
+            if(stat(path.Data(), &status) != 0 || !S_ISREG(status.st_mode)) { Changes.Delete(i); state->Hashes.Delete(i); }
+        }
+        #endif
+
+        // -- //
+        return Changes.Count;
+    };
+}
@@ -0,0 +1,64 @@
+/*
+-------------------------------------------------------------------------------
+    Filename: Common/Watcher.hpp
+-------------------------------------------------------------------------------
+*/
+
+// Header guard
+#pragma once
+// Includes
+#include "..\Common.hpp"
+#include "..\Common\Array.hpp"
+#include "..\Common\Path.hpp"
+#include "..\Common\String.hpp"
+#include "..\Common\StringView.hpp"
+
+// --------------------------------------------------------------------------------------------
+namespace R2D
+{
+    // ----------------------------------------------------------------------------------------
+    // Watches a directory tree for files being created or modified. The operating system queues change notifications (inotify on Linux,
+    // ReadDirectoryChangesW on Windows) which are drained without blocking by Poll(); Where neither is available, the tree is rescanned
+    // every Interval and compared against the previous scan instead. Editors tend to save a file in several steps, so all the changes
+    // gathered by a poll are coalesced and each changed file is reported once.
+    class Watcher
+    {
+    public:
+        // Constants
+
+        // The minimum time between rescans when polling, in nanoseconds.
+        static constexpr Long Interval = 500000000;
+
+    public:
+        // Members
+
+        // The directory being watched.
+        Path Root;
+        // The paths of the files created or modified before the last poll, relative to the root and using '/' separators.
+        Array<String> Changes;
+        // Handle to the platform's change notification state.
+        Void* Handle;
+
+    public:
+        // Constructors
+
+        // Default constructor.
+        Watcher() : Root(), Changes(), Handle(nullptr) {};
+        // Copy constructor.
+        Watcher(const Watcher& other) = delete;
+        // Move constructor.
+        Watcher(Watcher&& other) = delete;
+        // Destructor.
+        ~Watcher() { Close(); };
+
+        // Methods
+
+        // Start watching a directory and all of its subfolders, including ones created later. Either Windows or POSIX separators may be used.
+        Void Open(const StringView& path);
+        // Stop watching and release the changes.
+        Void Close();
+
+        // Replace Changes with the files created or modified since the previous poll, without blocking. Returns the number of changes.
+        Int Poll();
+    };
+}
@@ -30,39 +30,54 @@
 
 // String utilities for dealing UTF-16
 #include "..\Common\String.hpp"
+#include "..\Common\StringView.hpp"
 // -- //
 namespace R2D
 {
     // UTF-8 string to UTF-16 string conversion
-    inline std::wstring widen(const String& string)
+    inline std::wstring widen(const StringView& string)
     {
-        // Declare temporary storage to contain the converted string data.
-        auto temp = new wchar_t[string.Size()];
+        // Empty strings (such as empty paths and names) convert to empty strings.
+        if(!string.Length()) { return std::wstring(); }
+
+        // UTF-8 never takes fewer units than UTF-16, so the string's length is enough room for the converted string.
+        std::wstring result(size_t(string.Length()), L'\0');
 
-        // Convert the UTF-8 string to UTF-16.
-        Int result = MultiByteToWideChar(CP_UTF8, 0, string.Data, string.Size(), temp, string.Size());
+        // Convert the UTF-8 string to UTF-16, directly into the result.
+        Int length = MultiByteToWideChar(CP_UTF8, 0, string.Data(), string.Length(), &result[0], string.Length());
         // Debug check
-        Assert(result > 0, "There was a problem converting the string.");
+        Assert(length > 0, "There was a problem converting the string.");
 
-        // Construct and return the heap-allocated string.
-        return std::wstring(temp, result);
+        // Trim the result to the converted length.
+        result.resize(size_t((length > 0) ? length : 0));
+        return result;
 
-        //return std::wstring_convert<std::codecvt_utf8<wchar_t>>().from_bytes(string.Data);
+        //return std::wstring_convert<std::codecvt_utf8<wchar_t>>().from_bytes(string.Data());
     };
 
     // UTF-16 string to UTF-8 string conversion
     inline String narrow(const std::wstring& wstring)
     {
+        // Empty strings convert to empty strings.
+        if(wstring.empty()) { return String(); }
+
+        // Measure the converted string, since a UTF-16 unit can take up to three UTF-8 units.
+        Int size = WideCharToMultiByte(CP_UTF8, 0, wstring.c_str(), int(wstring.length()), NULL, 0, NULL, NULL);
+        // Debug check
+        Assert(size > 0, "There was a problem converting the string.");
+        // -- //
+        if(size <= 0) { return String(); }
+
         // Declare temporary storage to contain the converted string data.
-        auto temp = new char[wstring.size()];
+        Byte* temp = (Byte*)Memory::Request(size);
 
         // Convert the UTF-16 string to UTF-8.
-        Int result = WideCharToMultiByte(CP_UTF8, 0, wstring.c_str(), int(wstring.length()), temp, int(wstring.size()), NULL, NULL);
-        // Debug check
-        Assert(result > 0, "There was a problem converting the string.");
+        Int result = WideCharToMultiByte(CP_UTF8, 0, wstring.c_str(), int(wstring.length()), temp, size, NULL, NULL);
 
-        // Construct and return the heap-allocated string.
-        return String(temp, result);
+        // Copy the converted string and release the temporary storage.
+        String string(temp, result);
+        Memory::Free(temp);
+        return string;
 
         //auto string = std::wstring_convert<std::codecvt_utf8<wchar_t>>().to_bytes(wstring);
         //return String(string.c_str(), Int(string.length()));
@@ -334,4 +334,17 @@ namespace R2D
         time->Frame++;
         // TODO: Signal the next frame rather than the current frame (as signaling the first frame, frame 0, triggers instantly as the fence is already 0).
     };
+
+    // ----------------------------------------------------------------------------------------
+    Void Graphics::Manager::Wait()
+    {
+        // Wait for both frames' events; Frames that aren't in flight have theirs signalled already.
+        // The wait interval of 1000ms is for debug purposes and should be disabled when not debugging.
+        for(Int i = 0; i < 2; i++)
+        {
+            DWORD wait = WaitForSingleObjectEx(D3D.FenceEvent[i], 1000, FALSE);
+            // Debug check
+            Assert(wait == WAIT_OBJECT_0, "The wait event has timed out.");
+        }
+    };
 }
@@ -92,6 +92,8 @@ namespace R2D
             Void Upload();
             // Executes any queued commands and presents the result of the frame.
             Void Present();
+            // Blocks until the GPU has finished every frame in flight, so the resources they use can be replaced.
+            Void Wait();
         };
     }
 }
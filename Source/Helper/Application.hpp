@@ -83,6 +83,9 @@ namespace R2D
                 // Prepare the frame.
                 running = R2D::Update();
 
+                // Reload the resources changed since the last frame.
+                Resource::Manager::Singleton->Update();
+
                 // Update procedure.
                 graphics->Begin();
                 input->Update();
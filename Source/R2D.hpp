@@ -12,16 +12,32 @@
 // Common module
 #include "Common.hpp"
 #include "Common\Array.hpp"
+#include "Common\Atom.hpp"
+#include "Common\BTree.hpp"
+#include "Common\ConcurrentMap.hpp"
+#include "Common\ConcurrentQueue.hpp"
 #include "Common\Directory.hpp"
 #include "Common\File.hpp"
+#include "Common\FileQueue.hpp"
+#include "Common\FileWriter.hpp"
+#include "Common\FrozenMap.hpp"
 #include "Common\Hash.hpp"
 #include "Common\Map.hpp"
 #include "Common\Memory.hpp"
 #include "Common\Memory\Buffer.hpp"
+#include "Common\Memory\Epoch.hpp"
+#include "Common\Number.hpp"
+#include "Common\PagedArray.hpp"
+#include "Common\Path.hpp"
+#include "Common\RingQueue.hpp"
 #include "Common\Set.hpp"
+#include "Common\Sort.hpp"
 #include "Common\String.hpp"
+#include "Common\StringBuilder.hpp"
+#include "Common\StringView.hpp"
 #include "Common\Time.hpp"
 #include "Common\Types.hpp"
+#include "Common\Watcher.hpp"
 //#include "Common\Windows.hpp" // Only include into source files, not headers.
 
 // Graphics module
@@ -40,6 +56,8 @@
 
 // Resource module
 #include "Resource.hpp"
+#include "Resource\Archive.hpp"
+//#include "Resource\Cooker.hpp" // Optional
 //#include "Resource\Loader.hpp" // Optional
 #include "Resource\Material.hpp"
 #include "Resource\Shader.hpp"
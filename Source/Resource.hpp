@@ -8,8 +8,10 @@
 #pragma once
 // Includes
 #include "Common.hpp"
+#include "Common\Atom.hpp"
 #include "Common\Hash.hpp"
 #include "Common\String.hpp"
+#include "Common\StringView.hpp"
 
 // --------------------------------------------------------------------------------------------
 namespace R2D
@@ -34,7 +36,11 @@ namespace R2D
             // Integer constructor.
             constexpr ID(uInt id) : Handle(id) {};
             // String constructor.
-            constexpr ID(const String& string) : Handle(Hash::FNV32(string.Data, string.Length)) {};
+            constexpr ID(const String& string) : Handle(Hash::FNV32(string.Data(), string.Length())) {};
+            // View constructor.
+            constexpr ID(const StringView& view) : Handle(Hash::FNV32(view.Data(), view.Length())) {};
+            // Atom constructor. Reuses the atom's hash rather than hashing the string again.
+            constexpr ID(const Atom& atom) : Handle(atom.Hash) {};
             // C-String constructor.
             template <size_t count> constexpr ID(const char(&string)[count]) : Handle(Hash::FNV32(string)) {};
             // Copy constructor.
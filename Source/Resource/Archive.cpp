@@ -0,0 +1,335 @@
+/*
+-------------------------------------------------------------------------------
+    Filename: Resource/Archive.cpp
+-------------------------------------------------------------------------------
+*/
+
+// Includes
+#include "..\Resource\Archive.hpp"
+// -- //
+#include "..\Resource\Material.hpp"
+
+// --------------------------------------------------------------------------------------------
+namespace R2D
+{
+    // ----------------------------------------------------------------------------------------
+    // Write the part of a length that doesn't fit in a token's nibble, as a run of 255s followed by the remainder.
+    static uByte* ArchiveLength(uByte* output, Long length)
+    {
+        // -- //
+        for(length -= 15; length >= 255; length -= 255) { *output++ = 255; }
+        *output++ = uByte(length);
+        return output;
+    };
+
+    // ----------------------------------------------------------------------------------------
+    // Write a sequence: A token holding the literal and match lengths, the literals, and the match's offset if there is a match.
+    static uByte* ArchiveSequence(uByte* output, const uByte* literals, Long count, Long offset, Long length)
+    {
+        // Lengths of 15 or more spill out of the token's nibbles. Matches are at least 4 bytes long, so 4 is subtracted from them.
+        Long match = length ? length - 4 : 0;
+        uByte* token = output++;
+        *token = uByte(((count < 15) ? count : 15) << 4) | uByte((match < 15) ? match : 15);
+
+        // Write the literals.
+        if(count >= 15) { output = ArchiveLength(output, count); }
+        Memory::Copy(output, literals, count);
+        output += count;
+
+        // Write the match.
+        if(length)
+        {
+            *output++ = uByte(offset);
+            *output++ = uByte(offset >> 8);
+            // -- //
+            if(match >= 15) { output = ArchiveLength(output, match); }
+        }
+        // -- //
+        return output;
+    };
+
+    // ----------------------------------------------------------------------------------------
+    // Compress data into a buffer with room for at least size + size / 255 + 16 bytes. Returns the compressed size.
+    // Repeated sequences of 4 or more bytes within the previous 64 KiB are replaced by references to them, found through a table
+    // of the last position each 4-byte sequence was seen at; The final sequence only holds literals, marking the end of the data.
+    static Long ArchiveCompress(const uByte* source, Long size, uByte* destination)
+    {
+        Long table[4096];
+        // -- //
+        for(Int i = 0; i < 4096; i++) { table[i] = -1; }
+
+        // Helpers
+        uByte* output = destination;
+        Long anchor = 0;
+
+        // Look for a match at each position.
+        for(Long i = 0; i + 4 <= size;)
+        {
+            uInt sequence;
+            Memory::Copy(&sequence, source + i, 4);
+
+            // Look up and replace the sequence's last position.
+            uInt hash = (sequence * 2654435761u) >> 20;
+            Long candidate = table[hash];
+            table[hash] = i;
+
+            // Extend matches as far as they go.
+            if(candidate >= 0 && i - candidate <= 65535 && Memory::Compare(source + candidate, source + i, 4))
+            {
+                Long length = 4;
+                while(i + length < size && source[candidate + length] == source[i + length]) { length++; }
+                // -- //
+                output = ArchiveSequence(output, source + anchor, i - anchor, i - candidate, length);
+                i += length;
+                anchor = i;
+            }
+            else { i++; }
+        }
+
+        // End with the remaining literals.
+        output = ArchiveSequence(output, source + anchor, size - anchor, 0, 0);
+        return output - destination;
+    };
+
+    // ----------------------------------------------------------------------------------------
+    // Decompress data compressed by ArchiveCompress() into a buffer of exactly size bytes. Returns false if the data is corrupt; Nothing is
+    // ever read or written outside of the two buffers.
+    static Bool ArchiveDecompress(const uByte* source, Long stored, uByte* destination, Long size)
+    {
+        // Helpers
+        const uByte* input = source;
+        const uByte* end = source + stored;
+        uByte* output = destination;
+        uByte* limit = destination + size;
+
+        // Decode the sequences.
+        while(input < end)
+        {
+            uByte token = *input++;
+
+            // Copy the literals.
+            Long count = token >> 4;
+            if(count == 15) { uByte part; do { part = (input < end) ? *input++ : 0; count += part; } while(part == 255); }
+
+            // -- //
+            if(count > end - input || count > limit - output) { return false; }
+            Memory::Copy(output, input, count);
+            input += count;
+            output += count;
+
+            // The last sequence has no match.
+            if(input >= end) { break; }
+
+            // Decode the match.
+            Long offset = (input + 1 < end) ? Long(input[0]) | (Long(input[1]) << 8) : 0;
+            input += 2;
+            Long length = (token & 15) + 4;
+            if((token & 15) == 15) { uByte part; do { part = (input < end) ? *input++ : 0; length += part; } while(part == 255); }
+
+            // -- //
+            if(offset <= 0 || offset > output - destination || length > limit - output) { return false; }
+
+            // Copy the match a byte at a time, since it may overlap the bytes it produces.
+            const uByte* match = output - offset;
+            // -- //
+            for(Long i = 0; i < length; i++) { output[i] = match[i]; }
+            output += length;
+        }
+
+        // -- //
+        return output == limit;
+    };
+
+    // ----------------------------------------------------------------------------------------
+    Bool Resource::Archive::Open(const StringView& path)
+    {
+        // Debug check
+        Assert(!Head, "Attempting to open an archive that is already open.");
+
+        File file;
+        // Map the whole archive.
+        file.Open(path, File::Mode::Read);
+        // -- //
+        Bool valid = (file.Size >= Long(sizeof(Header)));
+        if(valid) { Mapped = file.Map(); }
+        file.Close();
+
+        // Helper
+        const Header* header = (const Header*)Mapped.Data;
+
+        // Validate the header, and that the index lies within the archive.
+        valid = valid && header->Magic == Signature && header->Version == Version && header->Size == Mapped.Size;
+        valid = valid && header->Capacity && POPCNT(header->Capacity) == 1 && header->Count * 2 <= header->Capacity && !(header->Index % Alignment);
+        valid = valid && header->Index >= Long(sizeof(Header)) && header->Index + Long(sizeof(Entry)) * header->Capacity <= header->Size;
+
+        // Validate every entry, so no payload can point outside of the payloads area; Stored payloads are used in-place at their full size.
+        const Entry* index = valid ? (const Entry*)((const Byte*)Mapped.Data + header->Index) : nullptr;
+        uInt count = 0;
+        // -- //
+        for(uInt i = 0; valid && (i < header->Capacity); i++)
+        {
+            // Helper
+            const Entry& entry = index[i];
+            // -- //
+            if(!entry.Key) { continue; }
+
+            count++;
+            valid = (entry.Method == Compression::None) || (entry.Method == Compression::LZ);
+            valid = valid && (entry.Size >= 0) && (entry.Stored >= 0) && (entry.Offset >= Long(sizeof(Header))) && (entry.Stored <= header->Index - entry.Offset);
+            valid = valid && ((entry.Method != Compression::None) || (entry.Size == entry.Stored));
+
+            // Materials and sources are extracted into objects of their own, so their sizes have to match those exactly; Shaders are
+            // sized with an Int once loaded. Entries of unknown kinds are rejected.
+            switch(entry.Type)
+            {
+                case Kind::Shader: { valid = valid && (entry.Size <= 0x7FFFFFFF); break; }
+                case Kind::Material: { valid = valid && (entry.Size == Long(sizeof(Material::Description))); break; }
+                case Kind::Source: { valid = valid && (entry.Size == Long(sizeof(Stamp))); break; }
+                default: { valid = false; break; }
+            }
+        }
+        // -- //
+        valid = valid && (count == header->Count);
+
+        // -- //
+        if(!valid) { Mapped.Release(); return false; }
+
+        // -- //
+        Head = header;
+        Index = index;
+        return true;
+    };
+
+    // ----------------------------------------------------------------------------------------
+    Bool Resource::Archive::Extract(const Entry& entry, Void* destination) const
+    {
+        // Debug check
+        Assert(entry.Offset >= Long(sizeof(Header)) && entry.Offset + entry.Stored <= Head->Index, "The resource's payload lies outside of the archive.");
+
+        // Copy or decompress the payload.
+        if(entry.Method == Compression::None) { Memory::Copy(destination, Payload(entry), entry.Size); return true; }
+        // -- //
+        return ArchiveDecompress((const uByte*)Payload(entry), entry.Stored, (uByte*)destination, entry.Size);
+    };
+
+    // ----------------------------------------------------------------------------------------
+    Void Resource::Archive::Writer::Open(const StringView& path)
+    {
+        // Debug check
+        Assert(!Target.Handle, "Attempting to open an archive writer that is already open.");
+
+        // Create the file and reserve room for the header, which is written last.
+        Target.Open(path, File::Mode::Overwrite);
+        Output.Open(Target);
+        // -- //
+        Header header = {};
+        Output.Write(header);
+    };
+
+    // ----------------------------------------------------------------------------------------
+    Bool Resource::Archive::Writer::Close()
+    {
+        // -- //
+        if(!Target.Handle) { return true; }
+
+        // Keep the index at most half full.
+        uInt capacity = 16;
+        while(capacity < uInt(Entries.Count) * 2) { capacity <<= 1; }
+
+        Array<Entry> index;
+        // Prepare the empty slots.
+        index.Reserve(capacity);
+        Memory::Zero(index.Data, sizeof(Entry) * capacity);
+        index.Count = capacity;
+
+        // Insert the entries.
+        for(Int i = 0; i < Entries.Count; i++)
+        {
+            // Helper
+            const Entry& entry = Entries[i];
+            uInt slot = entry.Key & (capacity - 1);
+
+            // Probe for an empty slot.
+            while(index[slot].Key)
+            {
+                // Debug check
+                Assert(index[slot].Key != entry.Key || index[slot].Type != entry.Type, "Cannot archive the resource. A resource of the same kind with that ID was already added.");
+                // -- //
+                slot = (slot + 1) & (capacity - 1);
+            }
+            // -- //
+            index[slot] = entry;
+        }
+
+        Header header = {};
+        // Describe the archive. The payloads are padded, so the index starts aligned.
+        header.Magic = Signature;
+        header.Version = Version;
+        header.Count = uInt(Entries.Count);
+        header.Capacity = capacity;
+        header.Index = Output.Offset + Output.Count;
+        header.Size = header.Index + Long(sizeof(Entry)) * capacity;
+
+        // Write the index, then the header over its placeholder.
+        Output.Write(index.Data, Long(capacity));
+        Output.Close();
+        Bool written = (Target.WriteAt(0, &header, sizeof(Header)) == Long(sizeof(Header))) && !Output.Failed;
+        Target.Close();
+
+        // -- //
+        index.Release();
+        Entries.Release();
+        return written;
+    };
+
+    // ----------------------------------------------------------------------------------------
+    Void Resource::Archive::Writer::Add(uInt key, Kind type, const Void* data, Long size, Bool compress)
+    {
+        Entry entry = {};
+        // Describe the entry.
+        entry.Key = key;
+        entry.Type = type;
+        entry.Method = Compression::None;
+        entry.Size = size;
+        entry.Stored = size;
+
+        // Compress the payload if asked to, but only keep the result if it's smaller.
+        if(compress && size > 0)
+        {
+            uByte* packed = (uByte*)Memory::Request(size + size / 255 + 16);
+            Long stored = ArchiveCompress((const uByte*)data, size, packed);
+            // -- //
+            if(stored < size)
+            {
+                entry.Method = Compression::LZ;
+                entry.Stored = stored;
+                Add(entry, packed);
+            }
+            // -- //
+            Memory::Free(packed);
+        }
+        // -- //
+        if(entry.Method == Compression::None) { Add(entry, data); }
+    };
+
+    // ----------------------------------------------------------------------------------------
+    Void Resource::Archive::Writer::Add(const Entry& entry, const Void* payload)
+    {
+        // Debug checks
+        Assert(Target.Handle, "Attempting to add a resource to an archive writer that isn't open.");
+        Assert(entry.Key, "Cannot archive a resource without an ID.");
+
+        // The payload starts where the last one's padding ended.
+        Entry copy = entry;
+        copy.Offset = Output.Offset + Output.Count;
+        Output.Write(payload, copy.Stored);
+
+        // Pad the payload, so the next one is aligned.
+        static const Byte padding[Alignment] = {};
+        Output.Write(padding, Long((Alignment - copy.Stored % Alignment) % Alignment));
+
+        // Grow the array geometrically.
+        if(Entries.Count == Entries.Capacity) { Entries.Reserve(Entries.Capacity ? Entries.Capacity : 64); }
+        Entries.Append(copy);
+    };
+}
@@ -0,0 +1,203 @@
+/*
+-------------------------------------------------------------------------------
+    Filename: Resource/Archive.hpp
+-------------------------------------------------------------------------------
+*/
+
+// Header guard
+#pragma once
+// Includes
+#include "..\Common.hpp"
+#include "..\Common\Array.hpp"
+#include "..\Common\File.hpp"
+#include "..\Common\FileWriter.hpp"
+#include "..\Common\StringView.hpp"
+// -- //
+#include "..\Resource.hpp"
+
+// --------------------------------------------------------------------------------------------
+namespace R2D
+{
+    // ----------------------------------------------------------------------------------------
+    namespace Resource
+    {
+        // ------------------------------------------------------------------------------------
+        // Packed archive of resources, so shipping thousands of them takes a single open and map instead of a directory walk and
+        // an open per file. An archive starts with a header, followed by the payloads (each aligned) and an index: A hash table of
+        // entries keyed by resource ID, with at least twice as many slots as entries so lookups only probe a slot or two.
+        // Stored payloads are used straight from the mapped archive; Compressed payloads are decompressed on extraction.
+        class Archive
+        {
+        public:
+            // Types
+
+            // The kinds of resources stored in an archive.
+            enum class Kind : Byte
+            {
+                Shader = 1, // Shader bytecode.
+                Material = 2, // A Material::Description.
+                Source = 3 // The Stamp of a file resources were cooked from, keyed by the hash of its path. Only used by the cooker.
+            };
+
+            // The ways an entry's payload can be stored.
+            enum class Compression : Byte
+            {
+                None = 0, // The payload is stored as is.
+                LZ = 1 // The payload is compressed with a byte-oriented LZ77 scheme, which decompresses at memory speed.
+            };
+
+            // The header at the start of an archive.
+            struct Header
+            {
+                // Identifies the file as an archive. Equal to Signature.
+                uInt Magic;
+                // The version of the format. Archives of other versions are rejected.
+                uInt Version;
+                // The number of entries in the archive.
+                uInt Count;
+                // The number of slots in the index. A power of two.
+                uInt Capacity;
+                // The offset of the index in the archive.
+                Long Index;
+                // The size of the archive in bytes, checked against the file's size so truncated archives are rejected.
+                Long Size;
+            };
+
+            // A slot in the index.
+            struct Entry
+            {
+                // The handle of the resource's ID, or zero if the slot is empty.
+                uInt Key;
+                // The kind of resource.
+                Kind Type;
+                // The way the payload is stored.
+                Compression Method;
+                // Unused; Keeps the layout explicit.
+                Byte Padding[2];
+                // The offset of the payload in the archive.
+                Long Offset;
+                // The size of the resource in bytes.
+                Long Size;
+                // The size of the payload in the archive, which is smaller than Size if it's compressed.
+                Long Stored;
+            };
+
+            // The resource stored by a source entry.
+            struct Stamp
+            {
+                // The size of the file in bytes.
+                Long Size;
+                // The time the file was last modified, in nanoseconds since 1970-01-01 UTC.
+                Long Modified;
+            };
+
+            // ------------------------------------------------------------------------------------
+            // Writes an archive. Payloads are streamed to the file as they're added and the index is written when it's closed.
+            class Writer
+            {
+            public:
+                // Members
+
+                // The archive being written.
+                File Target;
+                // Buffered writer for the archive.
+                FileWriter Output;
+                // The entries added so far.
+                Array<Entry> Entries;
+
+            public:
+                // Constructors
+
+                // Default constructor.
+                Writer() : Target(), Output(), Entries() {};
+                // Copy constructor.
+                Writer(const Writer& other) = delete;
+                // Move constructor.
+                Writer(Writer&& other) = delete;
+                // Destructor.
+                ~Writer() { Close(); };
+
+                // Methods
+
+                // Create the archive, replacing any existing file.
+                Void Open(const StringView& path);
+                // Write the index and header, and close the archive. Returns false if the archive couldn't be written in full, e.g. on a full disk.
+                Bool Close();
+
+                // Add a resource to the archive. Each ID may only be added once per kind. If compress is set, the payload is compressed
+                // unless that doesn't make it smaller; Compressed payloads have to be copied out of the archive to be used.
+                Void Add(uInt key, Kind type, const Void* data, Long size, Bool compress = false);
+                // Add a resource that's already in archive form, such as one copied from another archive, along with its payload as stored.
+                Void Add(const Entry& entry, const Void* payload);
+            };
+
+        public:
+            // Constants
+
+            // The value of every archive header's Magic member; "R2DA" in little-endian byte order.
+            static constexpr uInt Signature = 0x41443252;
+            // The current version of the format.
+            static constexpr uInt Version = 1;
+            // The alignment of the payloads within the archive.
+            static constexpr Long Alignment = 16;
+
+        public:
+            // Members
+
+            // The archive's contents, mapped into memory.
+            File::View Mapped;
+            // The archive's header, or a nullptr if no archive is open.
+            const Header* Head;
+            // The slots of the index.
+            const Entry* Index;
+
+        public:
+            // Constructors
+
+            // Default constructor.
+            Archive() : Mapped(), Head(nullptr), Index(nullptr) {};
+            // Copy constructor.
+            Archive(const Archive& other) = delete;
+            // Move constructor.
+            Archive(Archive&& other) : Mapped(Move(other.Mapped)), Head(other.Head), Index(other.Index) { other.Head = nullptr; other.Index = nullptr; };
+            // Destructor.
+            ~Archive() { Release(); };
+
+            // Methods
+
+            // Map an archive into memory and validate its header and index. Returns false (leaving Head a nullptr) if the file isn't a valid
+            // archive. Every entry of an opened archive is of a known kind, and materials and sources are exactly the size of the objects
+            // they're extracted into.
+            Bool Open(const StringView& path);
+            // Unmap the archive. Payloads used in-place become invalid.
+            Void Release() { Mapped.Release(); Head = nullptr; Index = nullptr; };
+
+            // Look up a resource's entry, or return a nullptr if the archive doesn't contain it.
+            const Entry* Find(uInt key, Kind type) const
+            {
+                // -- //
+                if(!Head || !key) { return nullptr; }
+
+                // Resource IDs are already hashes, so they're masked into slots directly and probed linearly from there.
+                uInt mask = Head->Capacity - 1;
+                // -- //
+                for(uInt slot = key & mask; Index[slot].Key; slot = (slot + 1) & mask)
+                {
+                    // -- //
+                    if(Index[slot].Key == key && Index[slot].Type == type) { return Index + slot; }
+                }
+                // -- //
+                return nullptr;
+            };
+
+            // Retrieve a pointer to an entry's payload within the mapped archive. Only usable in-place if the payload isn't compressed.
+            const Void* Payload(const Entry& entry) const
+            {
+                return (const Byte*)Mapped.Data + entry.Offset;
+            };
+            // Copy an entry's resource into a buffer with room for its Size bytes, decompressing it if needed. Returns false if the
+            // compressed payload is corrupt, in which case the buffer's contents are undefined.
+            Bool Extract(const Entry& entry, Void* destination) const;
+        };
+    }
+}
@@ -0,0 +1,516 @@
+/*
+-------------------------------------------------------------------------------
+    Filename: Resource/Cooker.cpp
+-------------------------------------------------------------------------------
+*/
+
+// Includes
+#include "..\Resource\Cooker.hpp"
+// -- //
+#include "..\Common\Directory.hpp"
+#include "..\Common\File.hpp"
+#include "..\Common\Map.hpp"
+#include "..\Common\Path.hpp"
+#include "..\Common\StringBuilder.hpp"
+// -- //
+#include "..\Resource\Archive.hpp"
+#include "..\Resource\Loader.hpp"
+
+// --------------------------------------------------------------------------------------------
+namespace R2D
+{
+    // ----------------------------------------------------------------------------------------
+    // Record a problem with a file.
+    static Void CookerError(Resource::Cooker& cooker, const StringView& path, const StringView& message)
+    {
+        StringBuilder builder;
+        // Prefix the message with the file's path.
+        builder.Append(path).Append(": ").Append(message);
+
+        // Grow the array geometrically.
+        if(cooker.Errors.Count == cooker.Errors.Capacity) { cooker.Errors.Reserve(cooker.Errors.Capacity ? cooker.Errors.Capacity : 16); }
+        cooker.Errors.Append(builder.Build());
+    };
+
+    // ----------------------------------------------------------------------------------------
+    // Allocate a map with room for a number of entries, keeping it at most half full since maps don't grow by themselves.
+    static Void CookerReserve(Map<uInt, Int>& map, Int count)
+    {
+        Int capacity = 64;
+        // -- //
+        while(capacity < count * 2) { capacity <<= 1; }
+        map.Expand(capacity);
+    };
+
+    // ----------------------------------------------------------------------------------------
+    // Check if a cached fragment is up to date; That is, if it's a valid archive and every file it was cooked from still has the same
+    // size and modification time. The files in the content directory are looked up by the hashes of their paths.
+    static Bool CookerFresh(const Path& fragment, const Directory::Listing& listing, const Map<uInt, Int>& files)
+    {
+        Resource::Archive archive;
+        // -- //
+        if(!File::Exists(fragment) || !archive.Open(fragment)) { return false; }
+
+        // Compare the source files.
+        for(uInt i = 0; i < archive.Head->Capacity; i++)
+        {
+            // Helper
+            const Resource::Archive::Entry& entry = archive.Index[i];
+            // -- //
+            if(!entry.Key || entry.Type != Resource::Archive::Kind::Source) { continue; }
+
+            // Files that have been removed make the fragment stale too.
+            Int* index = files.Find(entry.Key);
+            // -- //
+            if(!index) { return false; }
+
+            Resource::Archive::Stamp source;
+            // Opening the archive checked that the entry is the size of a stamp.
+            if(!archive.Extract(entry, &source)) { return false; }
+            // -- //
+            if(source.Size != listing.Entries[*index].Size || source.Modified != listing.Entries[*index].Modified) { return false; }
+        }
+        // -- //
+        return true;
+    };
+
+    // ----------------------------------------------------------------------------------------
+    // Parse, validate and cook a definition into a fragment. Returns false if the definition has problems, in which case they're recorded
+    // and no fragment is written.
+    static Bool CookerDefinition(Resource::Cooker& cooker, const Path& definition, const Path& fragment, const Directory::Listing& listing, const Map<uInt, Int>& files)
+    {
+        // Helpers
+        typedef Resource::Loader::TXT::Description Description;
+        Int errors = cooker.Errors.Count;
+
+        File file;
+        // Map the definition, which is parsed once from start to end.
+        file.Open(definition, File::Mode::Read);
+        File::View view = file.Map();
+        view.Advise(File::Access::Sequential);
+        file.Close();
+
+        // The tag structure references the view's data, so it's only used within the view's lifetime.
+        Memory::Buffer buffer = view.Contents();
+
+        Resource::Loader::TXT txt;
+        Array<Description> descriptions;
+        Array<String> problems;
+        // Load the tag structure and describe the resources, with local paths relative to the folder containing the definition.
+        txt.Load(buffer);
+        txt.Describe(Path(definition.Parent()), descriptions, problems);
+
+        // Report the malformed definitions.
+        for(Int i = 0; i < problems.Count; i++) { CookerError(cooker, definition, problems[i]); problems[i].~String(); }
+        // -- //
+        problems.Release();
+
+        // Validate the descriptions.
+        for(Int i = 0; i < descriptions.Count; i++)
+        {
+            // Helper
+            const Description& description = descriptions[i];
+
+            // Shaders need bytecode from a file in the content directory, so changes to it are noticed.
+            if(description.Type == Resource::Archive::Kind::Shader)
+            {
+                Int* index = files.Find(description.Source.Hash());
+                // -- //
+                if(!index || !listing.Entries[*index].Size)
+                {
+                    StringBuilder message;
+                    message.Append("The shader source file '").Append(description.Source.View()).Append(index ? StringView("' is empty.") : StringView("' isn't in the content directory."));
+                    CookerError(cooker, definition, message.View());
+                }
+            }
+
+            // Materials need a shader to run.
+            if(description.Type == Resource::Archive::Kind::Material && !description.Details.VS.Handle && !description.Details.CS.Handle)
+            {
+                CookerError(cooker, definition, "A material has neither a vertex shader nor a compute shader.");
+            }
+
+            // Each resource may only be defined once.
+            for(Int j = 0; j < i; j++)
+            {
+                // -- //
+                if(descriptions[j].Type != description.Type || descriptions[j].Key != description.Key) { continue; }
+
+                StringBuilder message;
+                message.Append("The resource '").Append(description.Name.Name()).Append("' is defined more than once.");
+                CookerError(cooker, definition, message.View());
+                break;
+            }
+        }
+
+        // Cook the resources.
+        Bool valid = (cooker.Errors.Count == errors);
+        // -- //
+        if(valid)
+        {
+            Resource::Archive::Writer writer;
+            writer.Open(fragment);
+
+            Array<uInt> recorded;
+            // Record the definition as a source of the fragment.
+            Int* self = files.Find(definition.Hash());
+            Resource::Archive::Stamp source = { listing.Entries[*self].Size, listing.Entries[*self].Modified };
+            // -- //
+            writer.Add(definition.Hash(), Resource::Archive::Kind::Source, &source, sizeof(Resource::Archive::Stamp));
+
+            // Add the resources.
+            for(Int i = 0; i < descriptions.Count; i++)
+            {
+                // Helper
+                const Description& description = descriptions[i];
+
+                // Add the material's description.
+                if(description.Type == Resource::Archive::Kind::Material)
+                {
+                    writer.Add(description.Key, description.Type, &description.Details, sizeof(description.Details));
+                    continue;
+                }
+
+                File shader;
+                // Add the shader's bytecode.
+                shader.Open(description.Source, File::Mode::Read);
+                File::View bytecode = shader.Map();
+                shader.Close();
+                // -- //
+                writer.Add(description.Key, description.Type, bytecode.Data, bytecode.Size, cooker.Compress);
+
+                // Record the bytecode's file as a source of the fragment, once.
+                uInt hash = description.Source.Hash();
+                Bool known = false;
+                for(Int j = 0; j < recorded.Count; j++) { known |= (recorded[j] == hash); }
+                // -- //
+                if(!known)
+                {
+                    Int* index = files.Find(hash);
+                    source = { listing.Entries[*index].Size, listing.Entries[*index].Modified };
+                    writer.Add(hash, Resource::Archive::Kind::Source, &source, sizeof(Resource::Archive::Stamp));
+
+                    // Grow the array geometrically.
+                    if(recorded.Count == recorded.Capacity) { recorded.Reserve(recorded.Capacity ? recorded.Capacity : 8); }
+                    recorded.Append(hash);
+                }
+            }
+
+            // A partly written fragment is deleted, so it's cooked again next time.
+            if(!writer.Close()) { CookerError(cooker, fragment, "The fragment couldn't be written in full."); File::Delete(fragment); valid = false; }
+            // -- //
+            recorded.Release();
+        }
+
+        // Release the descriptions.
+        for(Int i = 0; i < descriptions.Count; i++) { descriptions[i].~Description(); }
+        // -- //
+        descriptions.Release();
+        return valid;
+    };
+
+    // ----------------------------------------------------------------------------------------
+    // Delete the fragments in the cache directory that don't belong to any of the definitions, such as those of definitions that have been
+    // removed or renamed, so the cache doesn't keep growing.
+    static Void CookerPrune(const Path& folder, const Array<Path>& fragments)
+    {
+        Map<uInt, Int> known;
+        // Index the fragments by the hashes of their paths.
+        CookerReserve(known, fragments.Count);
+        // -- //
+        for(Int i = 0; i < fragments.Count; i++) { if(!known.Find(fragments[i].Hash())) { known.Add(fragments[i].Hash(), i); } }
+
+        Directory directory;
+        // List the cache directory.
+        directory.Read(folder);
+
+        // Helpers
+        Path path(folder);
+        Int length = path.Length();
+        uInt digest = path.Hash();
+
+        // Delete the unknown fragments; Other files are left alone.
+        for(Int i = 0; i < directory.Files.Count; i++)
+        {
+            // -- //
+            path.Join(directory.Files[i]);
+            if(path.Extension() == StringView("r2da") && !known.Find(path.Hash())) { File::Delete(path); }
+            path.Truncate(length, digest);
+        }
+    };
+
+    // ----------------------------------------------------------------------------------------
+    // Check the fragments against each other: Every resource may only be defined once, and every shader a material uses has to exist.
+    static Void CookerValidate(Resource::Cooker& cooker, const Array<Path>& definitions, const Array<Resource::Archive>& parts)
+    {
+        // Helper
+        Int count = 0;
+        for(Int i = 0; i < parts.Count; i++) { count += Int(parts[i].Head->Count); }
+
+        Map<uInt, Int> shaders, materials;
+        // Index the resources by their IDs, mapped to the definitions they come from.
+        CookerReserve(shaders, count);
+        CookerReserve(materials, count);
+        // -- //
+        for(Int i = 0; i < parts.Count; i++)
+        {
+            for(uInt j = 0; j < parts[i].Head->Capacity; j++)
+            {
+                // Helper
+                const Resource::Archive::Entry& entry = parts[i].Index[j];
+                // -- //
+                if(!entry.Key || entry.Type == Resource::Archive::Kind::Source) { continue; }
+
+                // Helper
+                Map<uInt, Int>& map = (entry.Type == Resource::Archive::Kind::Shader) ? shaders : materials;
+                Int* other = map.Find(entry.Key);
+
+                // Report resources defined by several definitions.
+                if(other)
+                {
+                    StringBuilder message;
+                    message.Append("A resource is also defined by '").Append(definitions[*other].View()).Append("'.");
+                    CookerError(cooker, definitions[i], message.View());
+                }
+                else { map.Add(entry.Key, i); }
+            }
+        }
+
+        // Check the materials' shaders.
+        for(auto iterator = materials.First(); !iterator.Last(); iterator.Next())
+        {
+            // Helpers
+            Int i = materials.Data[iterator.Index];
+            const Resource::Archive::Entry* entry = parts[i].Find(materials.Keys[iterator.Index], Resource::Archive::Kind::Material);
+
+            Resource::Material::Description description;
+            // Read the material's description; Opening the fragment checked that it's the size of one.
+            if(!parts[i].Extract(*entry, &description)) { CookerError(cooker, definitions[i], "A material's cooked description is corrupt."); continue; }
+
+            // -- //
+            Bool vs = !description.VS.Handle || shaders.Find(description.VS.Handle);
+            Bool ps = !description.PS.Handle || shaders.Find(description.PS.Handle);
+            Bool cs = !description.CS.Handle || shaders.Find(description.CS.Handle);
+            // -- //
+            if(!vs || !ps || !cs) { CookerError(cooker, definitions[i], "A material uses a shader that isn't defined anywhere in the content directory."); }
+        }
+    };
+
+    // ----------------------------------------------------------------------------------------
+    Bool Resource::Cooker::Cook(const StringView& content, const StringView& output, const StringView& cache, Bool force)
+    {
+        // Start over.
+        Release();
+        Cooked = 0;
+        Reused = 0;
+        Linked = false;
+
+        // Resolve the paths; Relative paths are joined onto the working directory.
+        Path root, folder, archive;
+        // -- //
+        if(Directory::Working) { root = *Directory::Working; folder = *Directory::Working; archive = *Directory::Working; }
+        root.Join(content);
+        folder.Join(cache);
+        archive.Join(output);
+
+        Directory::Listing listing;
+        // Scan the content directory.
+        Directory::Scan(root, listing);
+
+        Map<uInt, Int> files;
+        // Index the files by the hashes of their paths.
+        CookerReserve(files, listing.Entries.Count);
+        // -- //
+        Path path(root);
+        Int length = path.Length();
+        uInt digest = path.Hash();
+        for(Int i = 0; i < listing.Entries.Count; i++)
+        {
+            // -- //
+            if(listing.Entries[i].Type != Directory::Kind::File) { continue; }
+
+            // -- //
+            path.Join(listing.Path(i));
+            if(!files.Find(path.Hash())) { files.Add(path.Hash(), i); }
+            path.Truncate(length, digest);
+        }
+
+        // -- //
+        if(!Directory::Create(folder)) { CookerError(*this, folder, "The cache directory couldn't be created."); return false; }
+
+        Array<Path> definitions;
+        Array<Path> fragments;
+        // Cook each definition whose fragment is missing or stale.
+        for(Int i = 0; i < listing.Entries.Count; i++)
+        {
+            // -- //
+            if(listing.Entries[i].Type != Directory::Kind::File) { continue; }
+
+            // Only definitions are cooked directly; Other files are cooked as part of the definitions referencing them.
+            path.Join(listing.Path(i));
+            // -- //
+            if(path.Extension() == StringView("txt"))
+            {
+                // Each definition's fragment is named after the hash of its path.
+                StringBuilder name;
+                name.Append(path.Hash()).Append(".r2da");
+                Path fragment = folder / name.View();
+
+                // Reuse the fragment if it's up to date, or cook it.
+                if(!force && CookerFresh(fragment, listing, files)) { Reused++; }
+                else if(CookerDefinition(*this, path, fragment, listing, files)) { Cooked++; }
+
+                // Grow the arrays geometrically.
+                if(definitions.Count == definitions.Capacity)
+                {
+                    definitions.Reserve(definitions.Capacity ? definitions.Capacity : 64);
+                    fragments.Reserve(fragments.Capacity ? fragments.Capacity : 64);
+                }
+
+                // -- //
+                definitions.Append(path);
+                fragments.Append(fragment);
+            }
+
+            // Restore the directory's path for the next file.
+            path.Truncate(length, digest);
+        }
+
+        // Link the archive if every definition is valid.
+        if(!Errors.Count)
+        {
+            Array<Archive> parts;
+            // Map the fragments.
+            parts.Reserve(fragments.Count);
+            // -- //
+            for(Int i = 0; i < fragments.Count; i++)
+            {
+                // -- //
+                parts.Append();
+                if(parts[i].Open(fragments[i])) { continue; }
+
+                // A fragment that's gone missing or was cut short since it was checked is cooked again.
+                if(CookerDefinition(*this, definitions[i], fragments[i], listing, files)) { Cooked++; }
+                // -- //
+                if(!parts[i].Open(fragments[i])) { CookerError(*this, fragments[i], "The fragment couldn't be read back after cooking it."); }
+            }
+
+            // Delete the fragments of definitions that are gone.
+            CookerPrune(folder, fragments);
+
+            // Link the fragments if they could all be read.
+            if(!Errors.Count)
+            {
+                // Helper
+                Int count = 0;
+                for(Int i = 0; i < parts.Count; i++) { count += Int(parts[i].Head->Count); }
+
+                Map<uInt, Int> sources;
+                // Index the files the fragments were cooked from (definitions and shader bytecode), mapped to the first fragment recording each.
+                CookerReserve(sources, count);
+                // -- //
+                for(Int i = 0; i < parts.Count; i++)
+                {
+                    for(uInt j = 0; j < parts[i].Head->Capacity; j++)
+                    {
+                        // Helper
+                        const Archive::Entry& entry = parts[i].Index[j];
+                        // -- //
+                        if(entry.Key && entry.Type == Archive::Kind::Source && !sources.Find(entry.Key)) { sources.Add(entry.Key, i); }
+                    }
+                }
+
+                // The archive records the files it was linked from; If nothing was cooked and they're the same, it's up to date. Comparing their
+                // sizes and modification times also catches fragments cooked since the archive was last linked, e.g. by a cook that was interrupted.
+                Bool current = !force && !Cooked && File::Exists(archive);
+                // -- //
+                if(current)
+                {
+                    Archive previous;
+                    current = previous.Open(archive);
+
+                    // Compare the files.
+                    count = 0;
+                    for(uInt i = 0; current && i < previous.Head->Capacity; i++) { count += (previous.Index[i].Key && previous.Index[i].Type == Archive::Kind::Source); }
+                    for(auto iterator = sources.First(); current && !iterator.Last(); iterator.Next())
+                    {
+                        // Helpers
+                        const Archive::Entry* entry = previous.Find(sources.Keys[iterator.Index], Archive::Kind::Source);
+                        const Archive::Entry* other = parts[sources.Data[iterator.Index]].Find(sources.Keys[iterator.Index], Archive::Kind::Source);
+                        // -- //
+                        current = (entry != nullptr);
+                        if(current)
+                        {
+                            Archive::Stamp linked, cooked;
+                            // Opening the archives checked that the entries are the size of stamps.
+                            current = previous.Extract(*entry, &linked) && parts[sources.Data[iterator.Index]].Extract(*other, &cooked);
+                            current = current && (linked.Size == cooked.Size) && (linked.Modified == cooked.Modified);
+                        }
+                    }
+                    // -- //
+                    current = current && (count == sources.Count);
+                }
+
+                // Check the fragments against each other, and link them.
+                if(!current)
+                {
+                    CookerValidate(*this, definitions, parts);
+                    // -- //
+                    if(!Errors.Count)
+                    {
+                        Archive::Writer writer;
+                        // Create the archive, and the folder it goes in.
+                        Directory::Create(archive.Parent());
+                        writer.Open(archive);
+
+                        // Copy the resources as they're stored in the fragments, followed by the source entries (once per file).
+                        for(Int i = 0; i < parts.Count; i++)
+                        {
+                            for(uInt j = 0; j < parts[i].Head->Capacity; j++)
+                            {
+                                // Helper
+                                const Archive::Entry& entry = parts[i].Index[j];
+                                // -- //
+                                if(entry.Key && entry.Type != Archive::Kind::Source) { writer.Add(entry, parts[i].Payload(entry)); }
+                            }
+                        }
+                        // -- //
+                        for(auto iterator = sources.First(); !iterator.Last(); iterator.Next())
+                        {
+                            // Helper
+                            const Archive& part = parts[sources.Data[iterator.Index]];
+                            const Archive::Entry* entry = part.Find(sources.Keys[iterator.Index], Archive::Kind::Source);
+                            // -- //
+                            writer.Add(*entry, part.Payload(*entry));
+                        }
+
+                        // A partly written archive is deleted rather than left for the game to reject.
+                        if(!writer.Close()) { CookerError(*this, archive, "The archive couldn't be written in full."); File::Delete(archive); }
+                        else { Linked = true; }
+                    }
+                }
+            }
+
+            // Unmap the fragments.
+            for(Int i = 0; i < parts.Count; i++) { parts[i].~Archive(); }
+            // -- //
+            parts.Release();
+        }
+
+        // Release the paths.
+        for(Int i = 0; i < definitions.Count; i++) { definitions[i].~Path(); fragments[i].~Path(); }
+        // -- //
+        definitions.Release();
+        fragments.Release();
+        return !Errors.Count;
+    };
+
+    // ----------------------------------------------------------------------------------------
+    Void Resource::Cooker::Release()
+    {
+        // Release the errors.
+        for(Int i = 0; i < Errors.Count; i++) { Errors[i].~String(); }
+        // -- //
+        Errors.Release();
+    };
+}
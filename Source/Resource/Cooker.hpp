@@ -0,0 +1,68 @@
+/*
+-------------------------------------------------------------------------------
+    Filename: Resource/Cooker.hpp
+-------------------------------------------------------------------------------
+*/
+
+// Header guard
+#pragma once
+// Includes
+#include "..\Common.hpp"
+#include "..\Common\Array.hpp"
+#include "..\Common\String.hpp"
+#include "..\Common\StringView.hpp"
+// -- //
+#include "..\Resource.hpp"
+
+// --------------------------------------------------------------------------------------------
+namespace R2D
+{
+    // ----------------------------------------------------------------------------------------
+    namespace Resource
+    {
+        // ------------------------------------------------------------------------------------
+        // Offline cooker turning a content directory of resource definitions into an archive, so nothing is parsed at startup.
+        // Each definition is parsed, validated and cooked into its own intermediate archive (a fragment) in a cache directory, along with
+        // the sizes and modification times of the files it was cooked from. The next cook reuses the fragments whose files haven't changed,
+        // and only relinks the archive when a definition was cooked, added or removed, or a fragment doesn't match the files it was linked from.
+        class Cooker
+        {
+        public:
+            // Members
+
+            // The problems found by the last cook. The archive isn't written if there are any.
+            Array<String> Errors;
+            // The number of definitions cooked by the last cook.
+            Int Cooked;
+            // The number of definitions whose cached fragments were reused by the last cook.
+            Int Reused;
+            // Set if the last cook wrote the archive; Clear if it was already up to date (or there were errors).
+            Bool Linked;
+            // Set to compress shader bytecode in the archive, which then has to be copied out of it when loaded instead of used in-place.
+            // Cached fragments don't record it, so changing it takes a forced cook.
+            Bool Compress;
+
+        public:
+            // Constructors
+
+            // Default constructor.
+            Cooker() : Errors(), Cooked(0), Reused(0), Linked(false), Compress(false) {};
+            // Copy constructor.
+            Cooker(const Cooker& other) = delete;
+            // Move constructor.
+            Cooker(Cooker&& other) : Errors(Move(other.Errors)), Cooked(other.Cooked), Reused(other.Reused), Linked(other.Linked), Compress(other.Compress) {};
+            // Destructor.
+            ~Cooker() { Release(); };
+
+            // Methods
+
+            // Cook the definitions in a content directory and its subfolders into an archive, keeping the fragments in the cache directory
+            // (which is created if needed). If force is set, every definition is cooked and the archive is relinked regardless.
+            // Returns false if there were errors.
+            Bool Cook(const StringView& content, const StringView& archive, const StringView& cache, Bool force = false);
+
+            // Release the errors.
+            Void Release();
+        };
+    }
+}
@@ -8,12 +8,70 @@
 #include "..\Resource\Loader.hpp"
 // -- //
 #include "..\Common\File.hpp"
+#include "..\Common\FileWriter.hpp"
+#include "..\Common\Number.hpp"
+#include "..\Common\Path.hpp"
+#include "..\Common\StringBuilder.hpp"
 // -- //
 #include "..\Resource\Manager.hpp"
 
 // --------------------------------------------------------------------------------------------
 namespace R2D
 {
+    // ----------------------------------------------------------------------------------------
+    // The header at the start of a cached image of a tag structure, followed by its tags and then its values.
+    struct LoaderImage
+    {
+        // Identifies the file as an image. Equal to LoaderSignature.
+        uInt Magic;
+        // The version of the parser that built the tag structure.
+        uInt Version;
+        // The hash of the contents the tag structure was parsed from.
+        uLong Digest;
+        // The size of the contents in bytes.
+        Long Size;
+        // The number of tags in the image.
+        Int Tags;
+        // The number of values in the image.
+        Int Values;
+    };
+
+    // A tag in an image, with its pointers replaced by indices (or -1 if it has no children or values).
+    struct LoaderTag
+    {
+        Int Children;
+        Int Values;
+        Int ID;
+        Int Keyword;
+        Int ChildrenCount;
+        Int ValueCount;
+    };
+
+    // A value in an image, with its string replaced by its offset and length within the contents.
+    struct LoaderValue
+    {
+        Long Offset;
+        Long Length;
+        Long Number;
+        Double Real;
+    };
+
+    // The value of every image header's Magic member; "R2DT" in little-endian byte order.
+    static constexpr uInt LoaderSignature = 0x54443252;
+
+    // ----------------------------------------------------------------------------------------
+    // Build the path of the image of some contents in a cache directory, named after the hash of the contents.
+    static Path LoaderImagePath(const Path& cache, uLong digest)
+    {
+        Byte digits[16];
+        Int length = Number::FormatHex(digest, digits);
+
+        StringBuilder name;
+        // -- //
+        name.Append(StringView(digits, length)).Append(".txtc");
+        return cache / name.View();
+    };
+
     // ----------------------------------------------------------------------------------------
     Void Resource::Loader::TXT::Release()
     {
@@ -44,6 +102,15 @@ namespace R2D
             {
                 return Alphabetical(character) || Numerical(character);
             };
+            // Read the next character, or a null character once the end of the buffer is reached. The position still moves one past
+            // the end, so a token ending there is measured the same way as one ended by a character, and nothing past the buffer
+            // (which may be the end of a mapped file) is ever read.
+            static Byte Next(Memory::Buffer& buffer)
+            {
+                // -- //
+                if(buffer.Position >= buffer.Size) { buffer.Position = buffer.Size + 1; return 0; }
+                return buffer.Read<Byte>();
+            };
         };
 
         // Debug checks
@@ -56,6 +123,9 @@ namespace R2D
         // Z is the index of the first value in the tag's value array.
         // W is the number of values in the tag's value array.
         Array<Array<Int4>> tags;
+        // The index of every intermediate tag's name in the Keywords table (or -1), laid out the same as the tags. Resolved while the
+        // name is still at hand, so the characters are compared and a name merely sharing a keyword's hash isn't taken for it.
+        Array<Array<Int>> keywords;
 
         // Parse the memory buffer and store the tags in the intermediate tags structure.
         {
@@ -68,8 +138,8 @@ namespace R2D
             // Prepare the root scope.
             scopes[scope] = 0;
             tags.Expand(1);
+            keywords.Expand(1);
 
-            // TODO: Plaintext data is assumed to either be zero-size or end with a newline. Parsing text whose last character is not a newline results in undefined behaviour. Not really worth fixing?
             // TODO: Use exponential reservation (i.e. Reserve(Capacity)) instead of reserving a single entry at a time.
             // TODO: Prepare a root tag so that values may be declared for it.
             // TODO: String-building and Number-building loops read the next character before dropping it. This fine for formatting plaintext but is incorrect when terminating using quotations or braces.
@@ -78,19 +148,19 @@ namespace R2D
             while(true)
             {
                 // Terminate if the end of the buffer has been reached.
-                if(buffer.Position == buffer.Size) { break; }
+                if(buffer.Position >= buffer.Size) { break; }
 
                 // Read in the next character.
-                Byte character = buffer.Read<Byte>();
+                Byte character = Local::Next(buffer);
 
                 // Comments begin with a hash and end at the next newline.
                 if(character == '#')
                 {
                     while(true)
                     {
-                        character = buffer.Read<Byte>();
-                        // Ignore further characters until the next newline.
-                        if(character == 10) { break; }
+                        character = Local::Next(buffer);
+                        // Ignore further characters until the next newline (or the end of the buffer).
+                        if((character == 10) || (buffer.Position > buffer.Size)) { break; }
                     }
 
                     // Skip this character and begin working on the next one.
@@ -100,77 +170,106 @@ namespace R2D
                 // Tokens that begin with a letter are recognized to be tags.
                 if(Local::Alphabetical(character))
                 {
-                    // Prepare a string containing the first character.
-                    // TODO: Probably slow to allocate a string with length 1. Consider reserving capacity here.
-                    String name(character);
-                    // Parse in the rest of the tag's name.
+                    // Remember where the name starts (at the character that was just read).
+                    Long start = buffer.Position - 1;
+                    // Skip over the rest of the tag's name.
                     while(true)
                     {
                         // Read in the next character.
-                        character = buffer.Read<Byte>();
+                        character = Local::Next(buffer);
 
                         // Stop parsing the tag if the next letter isn't a letter or a number.
                         if(!Local::Alphanumeric(character)) { break; }
-
-                        // Append the character to the end of the name.
-                        name += character;
                     }
 
+                    // View the name in-place, excluding the character that ended it.
+                    StringView name(buffer.Data + start, Int(buffer.Position - 1 - start));
+
                     // Add the tag to the intermediate structure.
                     tags[scopes[scope]].Reserve(1);
-                    tag = tags[scopes[scope]].Append(Hash::FNV32(name.Data, name.Length), -1, Values.Count, 0);
+                    tag = tags[scopes[scope]].Append(Hash::FNV32(name), -1, Values.Count, 0);
+                    keywords[scopes[scope]].Reserve(1);
+                    keywords[scopes[scope]].Append(Keywords.Find(name.Data(), name.Length()));
                     // Update the most recently used scope.
                     recent = scopes[scope];
                 }
 
-                // Tokens that begin with a number are recognized to be number values.
-                if(Local::Numerical(character))
+                // Tokens that begin with a number, a sign or a decimal point are recognized to be number values.
+                if(Local::Numerical(character) || (character == '-') || (character == '+') || (character == '.'))
                 {
-                    // Initialize the number and begin parsing in the rest of its characters.
-                    Long number = Long(character) - '0';
-                    // -- //
-                    while(true)
+                    // View the rest of the buffer, starting at the character that was just read.
+                    Long start = buffer.Position - 1;
+                    StringView text(buffer.Data + start, Int(buffer.Size - start));
+                    Long number = 0;
+                    Double real = 0.0;
+                    Int length = 0;
+
+                    // Hexadecimal numbers are integers. A prefix without any digits after it reads as a zero followed by garbage below.
+                    if((text.Length() > 2) && (text[0] == '0') && ((text[1] == 'x') || (text[1] == 'X')))
                     {
-                        // Read in the next character.
-                        character = buffer.Read<Byte>();
-
-                        // Stop parsing the tag if the next letter isn't a number.
-                        if(!Local::Numerical(character)) { break; }
-
-                        // Append the character to the end of the number.
-                        number = (number * 10) + (Long(character) - '0');
+                        uLong hex = 0;
+                        length = Number::ParseHex(text, hex);
+                        number = Long(hex);
+                        real = Double(number);
+                    }
+                    // Otherwise the number is parsed both ways and is real if that reads further (a fraction or an exponent).
+                    if(!length)
+                    {
+                        Int integer = Number::Parse(text, number);
+                        length = Number::Parse(text, real);
+                        // -- //
+                        if(integer == length) { real = Double(number); }
+                        else { number = ((real > -9.2e18) && (real < 9.2e18)) ? Long(real) : 0; }
                     }
 
-                    // Add the value to the values array.
-                    Values.Reserve(1);
-                    Int index = Values.Append();
-                    Values[index].Number = number;
+                    // The number has to make up the whole token; A lone sign or point, or a number running into letters, isn't a value.
+                    Byte next = (start + length < buffer.Size) ? buffer.Data[start + length] : 0;
+                    Bool valid = length && !Local::Alphanumeric(next) && (next != '.');
 
-                    // Increase the number of values owned by the tag.
-                    tags[recent][tag].w += 1;
+                    // Debug check
+                    Warning(valid, "Skipped an invalid number in a resource definition.");
+
+                    if(valid)
+                    {
+                        // Skip over the number and read in the character that ended it.
+                        buffer.Position = start + length;
+                        character = Local::Next(buffer);
+
+                        // Add the value to the values array.
+                        Values.Reserve(1);
+                        Int index = Values.Append();
+                        Values[index].Number = number;
+                        Values[index].Real = real;
+
+                        // Increase the number of values owned by the tag.
+                        tags[recent][tag].w += 1;
+                    }
+                    else
+                    {
+                        // Skip over the rest of the token, so its remainder isn't read as a tag or another number.
+                        while(Local::Alphanumeric(character) || (character == '.') || (character == '-') || (character == '+')) { character = Local::Next(buffer); }
+                    }
                 }
 
                 // Tokens that begin with a double quotation mark are recognized as string values.
                 if(character == 34) // ASCII code for " is 34
                 {
-                    String string;
-                    // Begin parsing in the rest of the string's contents.
+                    // Remember where the string's contents start (after the quotation mark).
+                    Long start = buffer.Position;
+                    // Skip over the rest of the string's contents.
                     while(true)
                     {
                         // Read in the next character.
-                        character = buffer.Read<Byte>();
+                        character = Local::Next(buffer);
 
-                        // Stop parsing the string at the next double quotation mark.
-                        if(character == 34) { break; }
-
-                        // Append the character to the end of the string.
-                        string += character;
+                        // Stop parsing the string at the next double quotation mark (or the end of the buffer).
+                        if((character == 34) || (buffer.Position > buffer.Size)) { break; }
                     }
 
-                    // Add the value to the values array.
+                    // Add the value to the values array, viewing the string in-place (excluding the closing quotation mark).
                     Values.Reserve(1);
                     Int index = Values.Append();
-                    Values[index].String = Move(string);
+                    Values[index].String = StringView(buffer.Data + start, Int(buffer.Position - 1 - start));
 
                     // Increase the number of values owned by the tag.
                     tags[recent][tag].w += 1;
@@ -185,8 +284,10 @@ namespace R2D
 
                     // Allocate and assign the new scope to the current tag.
                     tags.Reserve(1);
+                    keywords.Reserve(1);
                     // -- //
                     tags[scopes[scope++]][tag].y = tags.Append();
+                    keywords.Append();
 
                     // Add the new scope to the stack.
                     scopes[scope] = tags[scopes[scope - 1]][tag].y;
@@ -198,10 +299,10 @@ namespace R2D
                 if(character == '}')
                 {
                     // Debug check
-                    Assert(scope > 0, "Cannot go down a scope from the root scope.");
+                    Warning(scope > 0, "Skipped an unmatched closing brace in a resource definition.");
 
-                    // Go to the previous scope.
-                    scope--;
+                    // Go to the previous scope, unless the brace is unmatched.
+                    if(scope > 0) { scope--; }
                     // Go to the next character.
                     continue;
                 }
@@ -244,8 +345,9 @@ namespace R2D
                 // Add the tag.
                 Int index = Tags.Append();
 
-                // Assign the tag hash.
+                // Assign the tag hash and its keyword.
                 Tags[index].ID = tag.x;
+                Tags[index].Keyword = keywords[i][j];
                 // Retrieve its scope index.
                 Int scope = tag.y;
 
@@ -272,13 +374,294 @@ namespace R2D
                 }
             }
         }
+
+        // Release the intermediate tag structure, since the cooker loads many definitions in one run.
+        for(Int i = 0; i < tags.Count; i++) { tags[i].Release(); keywords[i].Release(); }
+        // -- //
+        tags.Release();
+        keywords.Release();
+    };
+
+    // ----------------------------------------------------------------------------------------
+    Bool Resource::Loader::TXT::Restore(const Path& cache, const Memory::Buffer& buffer)
+    {
+        // Debug checks
+        Assert(Tags.Data == nullptr, "Attempting to restore resource definitions with a parser that has already been used.");
+        Assert(Values.Data == nullptr, "Attempting to restore resource definitions with a parser that has already been used.");
+
+        // Look up the image of the buffer's contents.
+        uLong digest = Hash::FNV64(buffer.Data, buffer.Size);
+        Path path = LoaderImagePath(cache, digest);
+        // -- //
+        if(!File::Exists(path)) { return false; }
+
+        File file;
+        File::View view;
+        // Map the image.
+        file.Open(path, File::Mode::Read);
+        // -- //
+        Bool valid = (file.Size >= Long(sizeof(LoaderImage)));
+        if(valid) { view = file.Map(); }
+        file.Close();
+
+        // Helper
+        const LoaderImage* image = (const LoaderImage*)view.Data;
+
+        // Validate the header against the buffer and this version of the parser, and check that the image isn't truncated.
+        valid = valid && image->Magic == LoaderSignature && image->Version == Version && image->Digest == digest && image->Size == buffer.Size;
+        valid = valid && image->Tags > 0 && image->Values >= 0;
+        valid = valid && view.Size == Long(sizeof(LoaderImage)) + Long(sizeof(LoaderTag)) * image->Tags + Long(sizeof(LoaderValue)) * image->Values;
+        // -- //
+        if(!valid) { return false; }
+
+        // Helpers
+        const LoaderTag* tags = (const LoaderTag*)(image + 1);
+        const LoaderValue* values = (const LoaderValue*)(tags + image->Tags);
+
+        // Rebuild the values, pointing their strings back into the buffer.
+        if(image->Values) { Values.Reserve(image->Values); }
+        // -- //
+        for(Int i = 0; valid && i < image->Values; i++)
+        {
+            // Helper
+            const LoaderValue& value = values[i];
+            // -- //
+            valid = (value.Offset >= 0) && (value.Length >= 0) && (value.Offset + value.Length <= buffer.Size);
+
+            Int index = Values.Append();
+            Values[index].String = valid ? StringView(buffer.Data + value.Offset, Int(value.Length)) : StringView();
+            Values[index].Number = value.Number;
+            Values[index].Real = value.Real;
+        }
+
+        // Rebuild the tags, turning their indices back into pointers.
+        Tags.Reserve(image->Tags);
+        // -- //
+        for(Int i = 0; valid && i < image->Tags; i++)
+        {
+            // Helper
+            const LoaderTag& tag = tags[i];
+            // -- //
+            valid = (tag.ChildrenCount >= 0) && (tag.ChildrenCount == 0 || (tag.Children > 0 && tag.Children + tag.ChildrenCount <= image->Tags));
+            valid = valid && (tag.ValueCount >= 0) && (tag.ValueCount == 0 || (tag.Values >= 0 && tag.Values + tag.ValueCount <= image->Values));
+
+            Int index = Tags.Append();
+            Tags[index].Children = tag.ChildrenCount ? Tags.Data + tag.Children : nullptr;
+            Tags[index].Values = tag.ValueCount ? Values.Data + tag.Values : nullptr;
+            Tags[index].ID = tag.ID;
+            Tags[index].Keyword = tag.Keyword;
+            Tags[index].ChildrenCount = tag.ChildrenCount;
+            Tags[index].ValueCount = tag.ValueCount;
+        }
+
+        // Discard corrupt images.
+        if(!valid) { Release(); }
+        // -- //
+        return valid;
+    };
+
+    // ----------------------------------------------------------------------------------------
+    Void Resource::Loader::TXT::Store(const Path& cache, const Memory::Buffer& buffer) const
+    {
+        // Debug check
+        Assert(Tags.Count, "Attempting to store resource definitions that haven't been loaded.");
+
+        LoaderImage image = {};
+        // Describe the image.
+        image.Magic = LoaderSignature;
+        image.Version = Version;
+        image.Digest = Hash::FNV64(buffer.Data, buffer.Size);
+        image.Size = buffer.Size;
+        image.Tags = Tags.Count;
+        image.Values = Values.Count;
+
+        File file;
+        FileWriter output;
+        // Write the image, replacing any previous one.
+        Path path = LoaderImagePath(cache, image.Digest);
+        file.Open(path, File::Mode::Overwrite);
+        output.Open(file);
+        output.Write(image);
+
+        // Write the tags, with their pointers as indices.
+        for(Int i = 0; i < Tags.Count; i++)
+        {
+            // Helper
+            const Tag& tag = Tags[i];
+
+            LoaderTag record;
+            // -- //
+            record.Children = tag.Children ? Int(tag.Children - Tags.Data) : -1;
+            record.Values = tag.Values ? Int(tag.Values - Values.Data) : -1;
+            record.ID = tag.ID;
+            record.Keyword = tag.Keyword;
+            record.ChildrenCount = tag.ChildrenCount;
+            record.ValueCount = tag.ValueCount;
+            output.Write(record);
+        }
+
+        // Write the values, with their strings as offsets into the buffer.
+        for(Int i = 0; i < Values.Count; i++)
+        {
+            // Helper
+            const Value& value = Values[i];
+
+            LoaderValue record;
+            // -- //
+            record.Offset = value.String.Length() ? Long(value.String.Data() - buffer.Data) : 0;
+            record.Length = value.String.Length();
+            record.Number = value.Number;
+            record.Real = value.Real;
+            output.Write(record);
+        }
+
+        // -- //
+        output.Close();
+        file.Close();
+
+        // A short write (e.g. on a full disk) leaves a truncated image behind, so delete it; The contents are simply parsed next time.
+        if(output.Failed) { File::Delete(path); }
+    };
+
+    // ----------------------------------------------------------------------------------------
+    Void Resource::Loader::TXT::Parse(const Path& directory)
+    {
+        // Helper
+        Resource::Manager* resources = Resource::Manager::Singleton;
+
+        Array<Description> descriptions;
+        Array<String> errors;
+        // Describe the resources. A definition that's malformed (e.g. one that's only been half saved) is skipped, and the rest are
+        // still created.
+        Describe(directory, descriptions, errors);
+
+        // Debug check
+        Warning(!errors.Count, "There were problems parsing a resource definition. The malformed resources were skipped.");
+
+        Array<File::Request> requests;
+        // Read every shader's bytecode in one batch, rather than opening and reading the files one after another.
+        for(Int i = 0; i < descriptions.Count; i++)
+        {
+            // -- //
+            if(descriptions[i].Type != Archive::Kind::Shader) { continue; }
+
+            // Grow the array geometrically.
+            if(requests.Count == requests.Capacity) { requests.Reserve(requests.Capacity ? requests.Capacity : 16); }
+            // -- //
+            Int index = requests.Append();
+            requests[index].Filename = descriptions[i].Source.View();
+        }
+        // -- //
+        File::ReadMany(requests.Data, requests.Count);
+        Int request = 0;
+
+        // Create the resources in the order they're defined.
+        for(Int i = 0; i < descriptions.Count; i++)
+        {
+            // Helper
+            const Description& description = descriptions[i];
+
+            // Create the resource.
+            switch(description.Type)
+            {
+                // Material resource.
+                case Archive::Kind::Material:
+                {
+                    // Add the material to the resource manager, or replace it if its definition is being reloaded.
+                    Resource::Material* material = resources->Materials.Find(description.Key);
+                    // -- //
+                    if(material) { material->Release(); }
+                    else { material = &resources->Materials.Add(description.Key); }
+
+                    // Initialize the material using the parsed description.
+                    material->Create(description.Details);
+
+                    break;
+                }
+
+                // Shader resource.
+                case Archive::Kind::Shader:
+                {
+                    // Helper
+                    File::Request& bytecode = requests[request++];
+
+                    // Reload the definition when the shader data file changes, even if it can't be read right now.
+                    resources->Depend(description.Source);
+
+                    // Skip shaders whose files are missing, empty or were cut short (e.g. while being saved); When reloading, the
+                    // previous shader is kept until the file is read in full.
+                    Bool complete = (bytecode.Result > 0) && (bytecode.Result == bytecode.Size);
+                    // Debug check
+                    Warning(complete, "There was a problem reading a shader file. The shader was skipped.");
+                    // -- //
+                    if(!complete)
+                    {
+                        if(bytecode.Destination) { Memory::Free(bytecode.Destination); }
+                        break;
+                    }
+
+                    // Add the shader to the resource manager, or replace it if its definition is being reloaded; The materials
+                    // using it are recreated afterwards.
+                    Resource::Shader* shader = resources->Shaders.Find(description.Key);
+                    // -- //
+                    if(shader)
+                    {
+                        shader->Release();
+                        if(resources->Reloaded.Count == resources->Reloaded.Capacity) { resources->Reloaded.Reserve(resources->Reloaded.Capacity ? resources->Reloaded.Capacity : 8); }
+                        resources->Reloaded.Append(description.Key);
+                    }
+                    else { shader = &resources->Shaders.Add(description.Key); }
+
+                    // Initialize the shader with the bytecode read for it.
+                    shader->Adopt(bytecode.Destination, Int(bytecode.Result));
+
+                    break;
+                }
+
+                // Source entries only exist in archives; Definitions never describe them.
+                case Archive::Kind::Source: { break; }
+            }
+        }
+
+        // Release the descriptions and the requests; The shaders own the buffers read for them.
+        for(Int i = 0; i < descriptions.Count; i++) { descriptions[i].~Description(); }
+        // -- //
+        descriptions.Release();
+        requests.Release();
+
+        // Release the errors.
+        for(Int i = 0; i < errors.Count; i++) { errors[i].~String(); }
+        // -- //
+        errors.Release();
     };
 
     // ----------------------------------------------------------------------------------------
-    Void Resource::Loader::TXT::Parse(const String& directory)
+    Void Resource::Loader::TXT::Describe(const Path& directory, Array<Description>& output, Array<String>& errors)
     {
+        // Local functions
+        struct Local
+        {
+            // Test if a tag's first value is a string, as resource names and paths are.
+            static Bool Named(const Tag& tag)
+            {
+                return (tag.ValueCount > 0) && tag.Values[0].String.Length();
+            };
+            // Record a problem with a definition, naming the resource if it has a name.
+            static Void Error(Array<String>& errors, const Tag& tag, const StringView& message)
+            {
+                StringBuilder builder;
+                // -- //
+                if(Named(tag)) { builder.Append("'").Append(tag.Values[0].String).Append("': "); }
+                builder.Append(message);
+
+                // Grow the array geometrically.
+                if(errors.Count == errors.Capacity) { errors.Reserve(errors.Capacity ? errors.Capacity : 8); }
+                errors.Append(builder.Build());
+            };
+        };
+
         // Helper
-        #define hash(string) Hash::FNV32(string)
+        #define keyword(string) Keywords.Index(string)
 
         // Loop through all of the root-level tags in the TXT structure.
         for(Int i = 0; i < Tags[0].ChildrenCount; i++)
@@ -287,95 +670,112 @@ namespace R2D
             auto& tag = Tags[0].Children[i];
 
             // Parse the tag.
-            switch(tag.ID)
+            switch(tag.Keyword)
             {
                 // Material resource defintion.
-                case hash("material"):
+                case keyword("material"):
                 {
-                    // TODO: Write comment explaining how material definitons are parsed.
+                    // A material is named by its first value, and lists the IDs of the shaders it uses as children.
+
+                    // Skip materials without a name, since there's nothing to refer to them by.
+                    if(!Local::Named(tag)) { Local::Error(errors, tag, "A material definition has no name."); break; }
 
                     Resource::Material::Description materialDesc;
                     // Prepare a material description.
                     materialDesc.Flags.DepthEnable = false; // Disable depth for now.
+                    Bool valid = true;
 
                     // Iterate through the tags in the material.
                     for(Int i = 0; i < tag.ChildrenCount; i++)
                     {
+                        // Helper
+                        auto& child = tag.Children[i];
+
+                        // Shaders are referred to by name.
+                        Bool shader = (child.Keyword == keyword("vshader")) || (child.Keyword == keyword("pshader")) || (child.Keyword == keyword("cshader"));
+                        // -- //
+                        if(shader && !Local::Named(child)) { Local::Error(errors, tag, "A material's shader is missing or isn't a name."); valid = false; continue; }
+
                         // Parse the tag.
-                        switch(tag.Children[i].ID)
+                        switch(child.Keyword)
                         {
                             // Vertex shader resource ID.
-                            case hash("vshader"):
+                            case keyword("vshader"):
                             {
-                                // Debug check
-                                Assert(tag.Children[i].Values[0].String.Data, "Unexpected tag type for the recognized key.");
-
                                 // Assign the vertex shader resource ID.
-                                materialDesc.VS = tag.Children[i].Values[0].String;
+                                materialDesc.VS = Atom(child.Values[0].String);
                                 break;
                             }
 
                             // Pixel shader resource ID.
-                            case hash("pshader"):
+                            case keyword("pshader"):
                             {
-                                // Debug check
-                                Assert(tag.Children[i].Values[0].String.Data, "Unexpected tag type for the recognized key.");
-
                                 // Assign the pixel shader resource ID.
-                                materialDesc.PS = tag.Children[i].Values[0].String;
+                                materialDesc.PS = Atom(child.Values[0].String);
                                 break;
                             }
 
                             // Compute shader resource ID.
-                            case hash("cshader"):
+                            case keyword("cshader"):
                             {
-                                // Debug check
-                                Assert(tag.Children[i].Values[0].String.Data, "Unexpected tag type for the recognized key.");
-
-                                // Assign the pixel shader resource ID.
-                                materialDesc.CS = tag.Children[i].Values[0].String;
+                                // Assign the compute shader resource ID.
+                                materialDesc.CS = Atom(child.Values[0].String);
                                 break;
                             }
                         }
                     }
+                    // -- //
+                    if(!valid) { break; }
 
-                    // Add the material to the resource manager.
-                    Resource::Material& material = Resource::Manager::Singleton->Materials.Add(tag.Values[0].String);
+                    // Grow the array geometrically.
+                    if(output.Count == output.Capacity) { output.Reserve(output.Capacity ? output.Capacity : 16); }
 
-                    // Initialize the material using the parsed description.
-                    material.Create(materialDesc);
+                    // Describe the material.
+                    Description& description = output[output.Append()];
+                    description.Type = Archive::Kind::Material;
+                    description.Name = Atom(tag.Values[0].String);
+                    description.Key = ID<Material>(description.Name).Handle;
+                    description.Details = materialDesc;
 
                     break;
                 }
 
                 // Shader resource definition.
-                case hash("shader"):
+                case keyword("shader"):
                 {
-                    // Hardcoded shader definition structure.
-                    // tag.ID = "shader"
+                    // Shader definition structure.
+                    // tag.Keyword = "shader"
                     // tag.Values[0].String = <resource name>
                     // tag.Children:
-                    // [0] tag.ID = "source"
-                    // [0] tag.Values[0].String = <filepath>
+                    // [n] tag.Keyword = "source"
+                    // [n] tag.Values[0].String = <filepath>
 
-                    // Debug check
-                    Assert(tag.Children[0].ID == hash("source"), "No source tag was found for the resource definition.");
+                    // Skip shaders without a name, since there's nothing to refer to them by.
+                    if(!Local::Named(tag)) { Local::Error(errors, tag, "A shader definition has no name."); break; }
+
+                    // Look up the source tag.
+                    const Tag* source = nullptr;
+                    for(Int j = 0; !source && j < tag.ChildrenCount; j++) { source = (tag.Children[j].Keyword == keyword("source")) ? tag.Children + j : nullptr; }
 
-                    File file;
-                    // Open the shader data file.
-                    file.Open(directory + tag.Children[0].Values[0].String, File::Mode::Read);
+                    // Skip shaders without a file to read their bytecode from.
+                    if(!source || !Local::Named(*source)) { Local::Error(errors, tag, "No source file was found for the shader definition."); break; }
 
-                    // Add the shader to the resource manager.
-                    Resource::Shader& shader = Resource::Manager::Singleton->Shaders.Add(tag.Values[0].String);
+                    // Grow the array geometrically.
+                    if(output.Count == output.Capacity) { output.Reserve(output.Capacity ? output.Capacity : 16); }
 
-                    // Initialize the shader with bytecode from the data file.
-                    shader.Create(nullptr, file.Size);
-                    file.Read(shader.Data, file.Size);
-                    file.Close();
+                    // Describe the shader, building its data file's path.
+                    Description& description = output[output.Append()];
+                    description.Type = Archive::Kind::Shader;
+                    description.Name = Atom(tag.Values[0].String);
+                    description.Key = ID<Shader>(description.Name).Handle;
+                    description.Source = directory / source->Values[0].String;
 
                     break;
                 }
             }
         }
+
+        // -- //
+        #undef keyword
     }
 }
@@ -9,10 +9,16 @@
 // Includes
 #include "..\Common.hpp"
 #include "..\Common\Array.hpp"
+#include "..\Common\Atom.hpp"
+#include "..\Common\Hash.hpp"
 #include "..\Common\Memory\Buffer.hpp"
+#include "..\Common\Path.hpp"
 #include "..\Common\String.hpp"
+#include "..\Common\StringView.hpp"
 // -- //
 #include "..\Resource.hpp"
+#include "..\Resource\Archive.hpp"
+#include "..\Resource\Material.hpp"
 
 // --------------------------------------------------------------------------------------------
 namespace R2D
@@ -29,13 +35,15 @@ namespace R2D
             public:
                 // Types
 
-                // A tag value, containing either a String or a Number.
+                // A tag value, containing either a String or a Number (integer, hexadecimal or real).
                 struct Value
                 {
-                    // A string value. Only valid if Data is actually allocated, otherwise the Value is actually a Number.
-                    String String;
-                    // A number value. This is only valid if the Data member is nullptr.
+                    // A string value, viewing the characters in the loaded buffer. Only valid if it isn't empty, otherwise the Value is actually a Number.
+                    StringView String;
+                    // A number value. This is only valid if the String member is empty. Real numbers are truncated.
                     Long Number = 0;
+                    // The number value as a real number. This is only valid if the String member is empty.
+                    Double Real = 0.0;
                 };
                 // A tag, containing an ID and zero or more values.
                 struct Tag
@@ -46,11 +54,36 @@ namespace R2D
                     Value* Values = nullptr;
                     // The hash of the tag's name.
                     Int ID = 0;
+                    // The index of the tag's name in the Keywords table, or -1 if the name isn't a recognized keyword.
+                    Int Keyword = -1;
                     // The number of child tags under the tag.
                     Int ChildrenCount = 0;
                     // The number of vtag values the tag contains.
                     Int ValueCount = 0;
                 };
+                // A resource described by the tag structure.
+                struct Description
+                {
+                    // The kind of resource.
+                    Archive::Kind Type = Archive::Kind::Shader;
+                    // The resource's name, interned so it outlives the loaded buffer and can be read back when debugging.
+                    Atom Name;
+                    // The handle of the resource's ID, built from the name's hash.
+                    uInt Key = 0;
+                    // The material's description. Only valid for materials.
+                    Resource::Material::Description Details;
+                    // The path of the file containing the shader's bytecode. Only valid for shaders.
+                    Path Source;
+                };
+
+            public:
+                // Constants
+
+                // Static; Table of the tag names recognized by the parser, resolved into dense indices at compile-time.
+                static constexpr Hash::Perfect<6> Keywords = Hash::Perfect<6>({ "material", "shader", "vshader", "pshader", "cshader", "source" });
+                // Static; The version of the tag structure built by Load(), recorded in cached images so images built by other versions are
+                // ignored. Bump it whenever Load() or the keyword table changes.
+                static constexpr uInt Version = 2;
 
             public:
                 // Members
@@ -76,10 +109,21 @@ namespace R2D
                 // Methods
 
                 // Parse the resource definition descriptions and store the tag structure.
+                // String values reference the buffer's data directly, so the buffer must outlive the tag structure.
                 Void Load(Memory::Buffer& buffer);
+                // Restore the tag structure of a buffer from its image in a cache directory, skipping parsing entirely. Images are named after
+                // a hash of the contents they were parsed from, so edited files simply miss. Returns false (leaving the object empty) if
+                // there's no valid image of the buffer's contents. String values reference the buffer's data, as with Load().
+                Bool Restore(const Path& cache, const Memory::Buffer& buffer);
+                // Store the image of the tag structure loaded from a buffer in a cache directory, for Restore() to find next time.
+                Void Store(const Path& cache, const Memory::Buffer& buffer) const;
                 // Parse the loaded tag structure and add the described resources to the resource graph.
                 // The directory is used for resolving local pathnames located in the descriptions.
-                Void Parse(const String& directory);
+                Void Parse(const Path& directory);
+                // Parse the loaded tag structure into descriptions of the resources, in the order they're defined, without creating them.
+                // The directory is used for resolving local pathnames located in the descriptions. Malformed definitions (such as a shader
+                // without a name or a source file) are skipped, and a message describing each of them is added to the errors.
+                Void Describe(const Path& directory, Array<Description>& output, Array<String>& errors);
                 // Release the memory allocated by the resource definitions and reset the object.
                 Void Release();
             };
@@ -9,6 +9,9 @@
 // -- //
 #include "..\Common\Directory.hpp"
 #include "..\Common\File.hpp"
+#include "..\Common\Path.hpp"
+// -- //
+#include "..\Graphics\Manager.hpp"
 // -- //
 #include "..\Resource\Loader.hpp"
 
@@ -44,61 +47,340 @@ namespace R2D
         }
         // -- // 
         Shaders.Release();
+
+        // Stop watching the resource locations.
+        for(Int i = 0; i < Watchers.Count; i++)
+        {
+            Watchers[i]->~Watcher();
+            Memory::Free(Watchers[i]);
+        }
+        // -- //
+        Watchers.Release();
+
+        // Unmap the archives, now that no shader uses them.
+        for(Int i = 0; i < Archives.Count; i++) { Archives[i].~Archive(); }
+        // -- //
+        Archives.Release();
+
+        // Release the definitions' paths and their dependencies.
+        for(Int i = 0; i < Definitions.Count; i++) { Definitions[i].~Path(); }
+        // -- //
+        Definitions.Release();
+        for(auto iterator = Dependencies.First(); !iterator.Last(); iterator.Next()) { Dependencies.Data[iterator.Index].Release(); }
+        // -- //
+        Dependencies.Release();
+        Reloaded.Release();
+        Cache.Release();
     };
 
     // ----------------------------------------------------------------------------------------
-    Void Resource::Manager::InitializeResourceLocation(const String& directory)
+    Void Resource::Manager::InitializeResourceLocation(const Path& directory, Bool watch)
     {
-        Directory folder;
-        // Retrieve the names of all the files and folders in the directory.
-        folder.Read(directory);
+        // Resolve the directory the same way the scan and watcher do, so the paths of changed files match the ones recorded here.
+        Path path;
+        // -- //
+        if(Directory::Working) { path = *Directory::Working; }
+        path.Join(directory);
+
+        Directory::Listing listing;
+        // Retrieve the files and folders in the whole directory tree at once.
+        Directory::Scan(path, listing);
 
-        // Iterate over the files in the directory.
-        for(Int i = 0; i < folder.Files.Count; i++)
+        // Start watching before loading, so changes made while loading aren't missed.
+        if(watch)
         {
-            // Helper
-            String& filename = folder.Files[i];
+            // Grow the array geometrically.
+            if(Watchers.Count == Watchers.Capacity) { Watchers.Reserve(Watchers.Capacity ? Watchers.Capacity : 4); }
+            // -- //
+            Watcher* watcher = Memory::Request<Watcher>();
+            watcher->Open(path);
+            Watchers.Append(watcher);
+        }
+
+        // A single path is reused for each file; Relative paths are joined onto the directory's path and truncated off again.
+        Int length = path.Length();
+        uInt digest = path.Hash();
 
-            // Check if the filename contains a file extension.
-            Int pos = filename.rFind('.');
+        // Iterate over the files in the tree.
+        for(Int i = 0; i < listing.Entries.Count; i++)
+        {
             // -- //
-            if(pos < filename.Length)
+            if(listing.Entries[i].Type != Directory::Kind::File) { continue; }
+
+            // Join the file's relative path onto the directory's path.
+            path.Join(listing.Path(i));
+            // Helper
+            StringView extension = path.Extension();
+
+            // If the file extension is three characters long..
+            if(extension.Length() == 3)
             {
-                // If the length of the filename is three characters long..
-                if((filename.Length - pos) == 4)
-                {
-                    // Extract and reverse the byte-order of the file extension substring (for readability purposes).
-                    Int extension = (filename[pos + 1] << 16) + (filename[pos + 2] << 8) + (filename[pos + 3]);
+                // Extract and reverse the byte-order of the file extension (for readability purposes).
+                Int code = (extension[0] << 16) + (extension[1] << 8) + (extension[2]);
 
-                    // Parse the extension.
-                    switch(extension)
+                // Parse the extension.
+                switch(code)
+                {
+                    // Resource Definition Tags resources file.
+                    // TODO: This is currently .txt to convey its plaintext contents. Considering using .rdf in the future.
+                    case 'txt':
                     {
-                        // Resource Definition Tags resources file.
-                        // TODO: This is currently .txt to convey its plaintext contents. Considering using .rdf in the future.
-                        case 'txt':
-                        {
-                            File file;
-                            // Open the file and load its contents.
-                            file.Open(directory + filename, File::Mode::Read);
-                            Memory::Buffer buffer = file.Load();
-                            file.Close();
-
-                            Resource::Loader::TXT txt;
-                            // Load and parse the TXT data.
-                            txt.Load(buffer);
-                            txt.Parse(directory);
-
-                            break;
-                        }
+                        // Grow the array geometrically.
+                        if(Definitions.Count == Definitions.Capacity) { Definitions.Reserve(Definitions.Capacity ? Definitions.Capacity : 64); }
+
+                        // Record the definition, which depends on its own file, and load it.
+                        Loading = Definitions.Append(path);
+                        Depend(path);
+                        Load(Loading);
+
+                        break;
                     }
                 }
             }
+
+            // Restore the directory's path for the next file.
+            path.Truncate(length, digest);
         }
+    }
+
+    // ----------------------------------------------------------------------------------------
+    Void Resource::Manager::InitializeResourceCache(const Path& directory)
+    {
+        // Resolve the directory, so changing the working directory later doesn't move the cache.
+        Cache.Clear();
+        if(Directory::Working) { Cache = *Directory::Working; }
+        Cache.Join(directory);
+
+        // Create the directory, or parse every time if that isn't possible.
+        Bool created = Directory::Create(Cache);
+        // Debug check
+        Warning(created, "Failed to create the resource cache directory. Resource definitions won't be cached.");
+        // -- //
+        if(!created) { Cache.Clear(); }
+    };
 
-        // Initialize all subfolders contained in the directory.
-        for(Int i = 0; i < folder.Folders.Count; i++)
+    // ----------------------------------------------------------------------------------------
+    Void Resource::Manager::InitializeResourceArchive(const Path& path)
+    {
+        // Grow the array geometrically.
+        if(Archives.Count == Archives.Capacity) { Archives.Reserve(Archives.Capacity ? Archives.Capacity : 4); }
+
+        // Map the archive.
+        Archive& archive = Archives[Archives.Append()];
+        Bool valid = archive.Open(path);
+
+        // Debug check
+        Assert(valid, "The file isn't a resource archive, or was written with another version of the format.");
+        // -- //
+        if(!valid) { Archives[--Archives.Count].~Archive(); return; }
+
+        // Everything in the archive is about to be read, so start reading it in ahead of time.
+        archive.Mapped.Advise(File::Access::Prefetch);
+
+        Int shaders = 0, materials = 0;
+        // Count the resources of each kind; Archives written by the cooker also hold the source stamps, which aren't loaded.
+        for(uInt i = 0; i < archive.Head->Capacity; i++)
         {
-            InitializeResourceLocation(directory + folder.Folders[i] + "/");
+            // Helper
+            const Archive::Entry& entry = archive.Index[i];
+            // -- //
+            if(entry.Key) { shaders += (entry.Type == Archive::Kind::Shader); materials += (entry.Type == Archive::Kind::Material); }
         }
-    }
+
+        // Make room for the archive's resources up front, since the maps don't grow by themselves.
+        while((Shaders.Count + shaders) * 2 > Shaders.Capacity) { Shaders.Expand(Shaders.Capacity ? Shaders.Capacity : 64); }
+        while((Materials.Count + materials) * 2 > Materials.Capacity) { Materials.Expand(Materials.Capacity ? Materials.Capacity : 64); }
+
+        // Load the shaders first, since materials are created from them.
+        for(uInt i = 0; i < archive.Head->Capacity; i++)
+        {
+            // Helper
+            const Archive::Entry& entry = archive.Index[i];
+            // -- //
+            if(!entry.Key || entry.Type != Archive::Kind::Shader) { continue; }
+
+            // Stored bytecode is used straight from the archive; Compressed bytecode is decompressed into memory of its own first, and
+            // skipped if it's corrupt (keeping any shader already loaded).
+            Void* bytecode = nullptr;
+            // -- //
+            if(entry.Method != Archive::Compression::None)
+            {
+                bytecode = Memory::Request(entry.Size);
+                Bool extracted = archive.Extract(entry, bytecode);
+
+                // Debug check
+                Warning(extracted, "An archived shader's bytecode is corrupt. The shader was skipped.");
+                // -- //
+                if(!extracted) { Memory::Free(bytecode); continue; }
+            }
+
+            // Add the shader, or replace it if it's already loaded.
+            Shader* shader = Shaders.Find(entry.Key);
+            // -- //
+            if(shader) { shader->Release(); }
+            else { shader = &Shaders.Add(entry.Key); }
+
+            // -- //
+            if(bytecode) { shader->Adopt(bytecode, Int(entry.Size)); }
+            else { shader->Reference(archive.Payload(entry), Int(entry.Size)); }
+        }
+
+        // Then load the materials.
+        for(uInt i = 0; i < archive.Head->Capacity; i++)
+        {
+            // Helper
+            const Archive::Entry& entry = archive.Index[i];
+            // -- //
+            if(!entry.Key || entry.Type != Archive::Kind::Material) { continue; }
+
+            Material::Description description;
+            // Read the material's description; Opening the archive checked that it's the size of one.
+            Bool extracted = archive.Extract(entry, &description);
+
+            // Debug check
+            Warning(extracted, "An archived material's description is corrupt. The material was skipped.");
+            // -- //
+            if(!extracted) { continue; }
+
+            // Add the material, or replace it if it's already loaded.
+            Material* material = Materials.Find(entry.Key);
+            // -- //
+            if(material) { material->Release(); }
+            else { material = &Materials.Add(entry.Key); }
+
+            // Create the material.
+            material->Create(description);
+        }
+    };
+
+    // ----------------------------------------------------------------------------------------
+    Void Resource::Manager::Update()
+    {
+        Array<Int> stale;
+        // Map the files changed in the watched locations back to the definitions to reload, each of which is only reloaded once.
+        for(Int i = 0; i < Watchers.Count; i++)
+        {
+            // Helper
+            Watcher* watcher = Watchers[i];
+            // -- //
+            for(Int j = 0, count = watcher->Poll(); j < count; j++)
+            {
+                Path path = watcher->Root / watcher->Changes[j];
+                Array<Int>* definitions = Dependencies.Find(path.Hash());
+                // -- //
+                if(!definitions) { continue; }
+
+                // Queue every definition referencing the file.
+                for(Int k = 0; k < definitions->Count; k++)
+                {
+                    // Helper
+                    Int definition = (*definitions)[k];
+
+                    // Skip definitions that are already queued.
+                    Bool queued = false;
+                    for(Int l = 0; l < stale.Count; l++) { queued |= (stale[l] == definition); }
+                    // -- //
+                    if(queued) { continue; }
+
+                    // Grow the array geometrically.
+                    if(stale.Count == stale.Capacity) { stale.Reserve(stale.Capacity ? stale.Capacity : 8); }
+                    stale.Append(definition);
+                }
+            }
+        }
+
+        // -- //
+        if(!stale.Count) { return; }
+
+        // The GPU may still be using the resources about to be replaced.
+        Graphics::Manager::Singleton->Wait();
+
+        // Reload the definitions. A definition whose file was deleted (or renamed away) keeps the resources it last loaded.
+        for(Int i = 0; i < stale.Count; i++)
+        {
+            // -- //
+            if(!File::Exists(Definitions[stale[i]])) { continue; }
+
+            Loading = stale[i];
+            Load(Loading);
+        }
+
+        // Materials are created from their shaders' bytecode, so the ones using reloaded shaders are recreated.
+        if(Reloaded.Count)
+        {
+            for(auto iterator = Materials.First(); !iterator.Last(); iterator.Next())
+            {
+                // Helper
+                Material& material = Materials.Data[iterator.Index];
+                const Material::Description& details = material.Details;
+
+                // Check if the material uses any of the reloaded shaders.
+                Bool uses = false;
+                for(Int j = 0; j < Reloaded.Count; j++)
+                {
+                    uses |= (details.VS == Reloaded[j]) || (details.PS == Reloaded[j]) || (details.CS == Reloaded[j]);
+                }
+
+                // -- //
+                if(uses) { material.Release(); material.Create(details); }
+            }
+            // -- //
+            Reloaded.Count = 0;
+        }
+
+        // -- //
+        stale.Release();
+    };
+
+    // ----------------------------------------------------------------------------------------
+    Void Resource::Manager::Load(Int definition)
+    {
+        // Helper
+        const Path& path = Definitions[definition];
+
+        File file;
+        // Open the file and map its contents, which are parsed once from start to end.
+        file.Open(path, File::Mode::Read);
+        File::View view = file.Map();
+        view.Advise(File::Access::Sequential);
+        file.Close();
+
+        // The tag structure references the view's data, so it's only used within the view's lifetime.
+        Memory::Buffer buffer = view.Contents();
+
+        Resource::Loader::TXT txt;
+        // Restore the tag structure from the cache if it holds an image of the same contents, otherwise parse it and cache its image.
+        if(!Cache.Length() || !txt.Restore(Cache, buffer))
+        {
+            txt.Load(buffer);
+            // -- //
+            if(Cache.Length()) { txt.Store(Cache, buffer); }
+        }
+
+        // Parse the TXT data. Local paths in the descriptions are relative to the folder containing the file.
+        txt.Parse(Path(path.Parent()));
+
+        // -- //
+        Loading = -1;
+    };
+
+    // ----------------------------------------------------------------------------------------
+    Void Resource::Manager::Depend(const Path& file)
+    {
+        // -- //
+        if(Loading < 0) { return; }
+
+        // Keep the map at most half full, since it doesn't grow by itself.
+        if(Dependencies.Count * 2 >= Dependencies.Capacity) { Dependencies.Expand(Dependencies.Capacity ? Dependencies.Capacity : 64); }
+
+        // Record the definition against the file, once, since reloading the definition records its dependencies again.
+        Array<Int>* definitions = Dependencies.Find(file.Hash());
+        // -- //
+        if(!definitions) { definitions = &Dependencies.Add(file.Hash()); }
+        for(Int i = 0; i < definitions->Count; i++) { if((*definitions)[i] == Loading) { return; } }
+
+        // Grow the array geometrically.
+        if(definitions->Count == definitions->Capacity) { definitions->Reserve(definitions->Capacity ? definitions->Capacity : 4); }
+        definitions->Append(Loading);
+    };
 }
@@ -8,10 +8,14 @@
 #pragma once
 // Includes
 #include "..\Common.hpp"
+#include "..\Common\Array.hpp"
 #include "..\Common\Map.hpp"
+#include "..\Common\Path.hpp"
 #include "..\Common\String.hpp"
+#include "..\Common\Watcher.hpp"
 // -- //
 #include "..\Resource.hpp"
+#include "..\Resource\Archive.hpp"
 #include "..\Resource\Material.hpp"
 #include "..\Resource\Shader.hpp"
 
@@ -32,6 +36,21 @@ namespace R2D
             // Map containing shader IDs linked to their shader resource.
             Map<ID<Shader>, Shader> Shaders;
 
+            // The paths of the resource definition files that have been loaded.
+            Array<Path> Definitions;
+            // Map from the hashes of the paths of the definition files, and of the files they reference, to the indices of the definitions to reload when the file changes.
+            Map<uInt, Array<Int>> Dependencies;
+            // Watchers of the resource locations whose definitions are reloaded when they change.
+            Array<Watcher*> Watchers;
+            // The index of the definition being loaded, or -1.
+            Int Loading;
+            // The shaders replaced while reloading definitions, whose materials have to be recreated.
+            Array<ID<Shader>> Reloaded;
+            // The archives resources have been loaded from. Kept mapped, since stored shaders use their bytecode in-place.
+            Array<Archive> Archives;
+            // The directory the parsed definitions are cached in, or empty if they're parsed every time.
+            Path Cache;
+
             // Static interface handle.
             static Manager* Singleton;
 
@@ -39,11 +58,13 @@ namespace R2D
             // Constructors
 
             // Default constructor.
-            Manager() :Materials(), Shaders() {};
+            Manager() :Materials(), Shaders(), Definitions(), Dependencies(), Watchers(), Loading(-1), Reloaded(), Archives(), Cache() {};
             // Copy constructor.
             Manager(const Manager& other) = delete;
             // Move constructor.
-            Manager(Manager&& other) : Materials(Move(other.Materials)), Shaders(Move(other.Shaders)) {};
+            Manager(Manager&& other) : Materials(Move(other.Materials)), Shaders(Move(other.Shaders)), Definitions(Move(other.Definitions)), Dependencies(Move(other.Dependencies)),
+                                       Watchers(Move(other.Watchers)), Loading(other.Loading), Reloaded(Move(other.Reloaded)), Archives(Move(other.Archives)),
+                                       Cache(Move(other.Cache)) { other.Loading = -1; };
             // Destructor.
             ~Manager() { Release(); };
 
@@ -55,7 +76,26 @@ namespace R2D
             Void Release();
 
             // Scan a directory and its subfolders for resource descriptions to load.
-            Void InitializeResourceLocation(const String& directory);
+            // If watch is set, Update() reloads the definitions whose files (or the files they reference) change afterwards.
+            // Definitions deleted from a watched location keep their resources loaded until the manager is released.
+            Void InitializeResourceLocation(const Path& directory, Bool watch = false);
+
+            // Cache the parsed definitions in a directory (which is created if needed), keyed by a hash of their contents, so unchanged
+            // definitions skip parsing the next time they're loaded. Set before the resource locations are initialized.
+            Void InitializeResourceCache(const Path& directory);
+
+            // Load every resource in an archive with a single open and map, instead of scanning a directory of definitions.
+            // Resources that were already loaded are replaced.
+            Void InitializeResourceArchive(const Path& path);
+
+            // Reload the definitions whose files have changed since the last update. Call between frames; If anything has to be
+            // reloaded, this waits for the GPU to finish the frames in flight first.
+            Void Update();
+
+            // Load a definition file, replacing the resources it defines if they already exist.
+            Void Load(Int definition);
+            // Record that the definition being loaded references a file, so the definition is reloaded when the file changes.
+            Void Depend(const Path& file);
         };
     }
 }
@@ -71,5 +71,6 @@ namespace R2D
 
         // Create the graphics state
         Resource.Create(stateDesc);
+        Details = description;
     };
 }
@@ -45,16 +45,18 @@ namespace R2D
 
             // The GPU resource the material owns.
             Graphics::State Resource;
+            // The description the material was created from, kept to recreate it when its shaders are reloaded.
+            Description Details;
 
         public:
             // Constructors.
 
             // Default constructor.
-            Material() : Resource() {};
+            Material() : Resource(), Details() {};
             // Copy constructor.
             Material(const Material& other) = delete;
             // Move constructor.
-            Material(Material&& other) : Resource(Move(other.Resource)) {};
+            Material(Material&& other) : Resource(Move(other.Resource)), Details(other.Details) {};
             // Destructor.
             ~Material() { Release(); };
 
@@ -8,6 +8,7 @@
 #pragma once
 // Includes
 #include "..\Common.hpp"
+#include "..\Common\File.hpp"
 #include "..\Common\Memory.hpp"
 // -- //
 #include "..\Resource.hpp"
@@ -28,16 +29,20 @@ namespace R2D
             Void* Data;
             // The size in bytes of the shader's bytecode data.
             Int Size;
+            // The mapped view of the file containing the bytecode, when the bytecode is used in-place instead of copied.
+            File::View Mapped;
+            // Set if the shader allocated the memory for its bytecode, and frees it when released.
+            Bool Owner;
 
         public:
             // Constructors
 
             // Default constructor.
-            Shader() : Data(nullptr), Size(0) {};
+            Shader() : Data(nullptr), Size(0), Owner(false) {};
             // Copy constructor.
             Shader(const Shader& other) = delete;
             // Move constructor.
-            Shader(Shader&& other) : Data(other.Data), Size(other.Size) { other.Data = nullptr; other.Size = 0; };
+            Shader(Shader&& other) : Data(other.Data), Size(other.Size), Mapped(Move(other.Mapped)), Owner(other.Owner) { other.Data = nullptr; other.Size = 0; other.Owner = false; };
             // Destructor.
             ~Shader() { Release(); };
 
@@ -45,9 +50,15 @@ namespace R2D
 
             // Allocate the shader and copy the supplied bytecode to it.
             // If data is a nullptr, only allocate memory for the shader bytecode.
-            Void Create(const Void* data, Int size) { Assert(!Data, "Attempting to initialize a shader that has already has data initialized."); Data = Memory::Request(size); if(data) { Memory::Copy(Data, data, size); } Size = size; }
-            // Release the memory allocated for the bytecode.
-            Void Release() { if(Data) { Memory::Free(Data); Data = nullptr; } Size = 0; };
+            Void Create(const Void* data, Int size) { Assert(!Data, "Attempting to initialize a shader that has already has data initialized."); Data = Memory::Request(size); if(data) { Memory::Copy(Data, data, size); } Size = size; Owner = true; }
+            // Use the bytecode in a mapped view of a file in-place, taking ownership of the view.
+            Void Create(File::View&& view) { Assert(!Data, "Attempting to initialize a shader that has already has data initialized."); Mapped = Move(view); Data = Mapped.Data; Size = Int(Mapped.Size); }
+            // Take ownership of bytecode allocated with Memory::Request(), such as a buffer filled by File::ReadMany().
+            Void Adopt(Void* data, Int size) { Assert(!Data, "Attempting to initialize a shader that has already has data initialized."); Data = data; Size = size; Owner = true; }
+            // Use bytecode that lives elsewhere in-place, such as in a mapped archive. The bytecode must outlive the shader.
+            Void Reference(const Void* data, Int size) { Assert(!Data, "Attempting to initialize a shader that has already has data initialized."); Data = (Void*)data; Size = size; }
+            // Release the memory allocated for the bytecode, or unmap the view containing it.
+            Void Release() { if(Mapped.Data) { Mapped.Release(); } else if(Owner) { Memory::Free(Data); } Data = nullptr; Size = 0; Owner = false; };
         };
     }
 }
@@ -0,0 +1,58 @@
+/*
+-------------------------------------------------------------------------------
+    Filename: Tools/Cook/Cook.cpp
+-------------------------------------------------------------------------------
+*/
+
+// Includes
+#include "..\..\Source\Common\StringBuilder.hpp"
+#include "..\..\Source\Resource\Cooker.hpp"
+// -- //
+#include <stdio.h>
+#include <string.h>
+
+// --------------------------------------------------------------------------------------------
+// Command-line front end for the resource cooker:
+//     Cook <content> <archive> [-cache <directory>] [-force] [-compress]
+// The cache directory defaults to the archive's path followed by ".cache". Returns zero if the archive is up to date.
+int main(int argc, char** argv)
+{
+    using namespace R2D;
+
+    // -- //
+    if(argc < 3)
+    {
+        printf("Usage: Cook <content> <archive> [-cache <directory>] [-force] [-compress]\n");
+        return 1;
+    }
+
+    // Helpers
+    StringView content(argv[1], Int(strlen(argv[1])));
+    StringView archive(argv[2], Int(strlen(argv[2])));
+    StringView cache;
+    Bool force = false;
+
+    Resource::Cooker cooker;
+    // Read the options.
+    for(Int i = 3; i < argc; i++)
+    {
+        // -- //
+        if(!strcmp(argv[i], "-cache") && i + 1 < argc) { i++; cache = StringView(argv[i], Int(strlen(argv[i]))); }
+        else if(!strcmp(argv[i], "-force")) { force = true; }
+        else if(!strcmp(argv[i], "-compress")) { cooker.Compress = true; }
+        else { printf("Unknown option '%s'.\n", argv[i]); return 1; }
+    }
+
+    StringBuilder folder;
+    // Keep the fragments next to the archive by default.
+    if(!cache.Length()) { folder.Append(archive).Append(".cache"); cache = folder.View(); }
+
+    // Cook the content.
+    Bool valid = cooker.Cook(content, archive, cache, force);
+
+    // Report the problems.
+    for(Int i = 0; i < cooker.Errors.Count; i++) { printf("%.*s\n", cooker.Errors[i].Length(), cooker.Errors[i].Data()); }
+    // -- //
+    printf("%d definitions cooked, %d reused. %s\n", cooker.Cooked, cooker.Reused, !valid ? "The archive wasn't written." : (cooker.Linked ? "The archive was linked." : "The archive is up to date."));
+    return valid ? 0 : 1;
+}
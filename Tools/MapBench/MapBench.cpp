@@ -0,0 +1,217 @@
+/*
+-------------------------------------------------------------------------------
+    Filename: Tools/MapBench/MapBench.cpp
+-------------------------------------------------------------------------------
+*/
+
+// Includes
+#include "..\..\Source\Common\Array.hpp"
+#include "..\..\Source\Common\ConcurrentMap.hpp"
+#include "..\..\Source\Common\Map.hpp"
+// -- //
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <thread>
+
+// --------------------------------------------------------------------------------------------
+// Workload run by every thread. Percentages of lookups and insertions, the rest of the operations are deletions.
+struct MapBenchWorkload
+{
+    // The name printed in the report.
+    const char* Name;
+    // The percentage of operations that are lookups.
+    R2D::Int Finds;
+    // The percentage of operations that are insertions.
+    R2D::Int Adds;
+};
+
+// --------------------------------------------------------------------------------------------
+// Run one workload on the specified number of threads and return the throughput in millions of operations per second.
+static R2D::Double MapBenchRun(const MapBenchWorkload& workload, R2D::Int threads, R2D::Int keys, R2D::Int operations)
+{
+    using namespace R2D;
+
+    ConcurrentMap<uInt, uLong> map;
+    // Start with half of the key range in the map so lookups hit and miss equally often.
+    {
+        Memory::Epoch::Guard guard;
+        // -- //
+        for(Int i = 0; i < keys; i += 2) { map.Add(guard, uInt(i), uLong(i)); }
+    }
+
+    // Helpers
+    std::atomic<Int> ready = 0;
+    std::atomic<Bool> start = false;
+    std::atomic<uLong> checksum = 0;
+
+    auto work = [&](Int index)
+    {
+        // Every thread uses its own random sequence (xorshift).
+        uInt state = 2463534242u + uInt(index) * 0x9E3779B9u;
+        uLong sum = 0;
+
+        // Wait for every thread to be ready, so they all start together.
+        ready.fetch_add(1);
+        while(!start.load()) { std::this_thread::yield(); }
+
+        for(Int i = 0; i < operations; i++)
+        {
+            state ^= state << 13; state ^= state >> 17; state ^= state << 5;
+            // -- //
+            uInt key = state % uInt(keys);
+            Int roll = Int((state >> 8) % 100);
+
+            Memory::Epoch::Guard guard;
+            // -- //
+            if(roll < workload.Finds) { const uLong* value = map.Find(guard, key); sum += value ? *value : 0; }
+            else if(roll < workload.Finds + workload.Adds) { sum += map.Add(guard, key, uLong(key)); }
+            else { sum += map.Delete(key) ? 1 : 0; }
+        }
+
+        // Keep the lookups from being optimized away.
+        checksum.fetch_add(sum);
+    };
+
+    // Spawn the threads and release them at once.
+    std::thread* workers = (std::thread*)Memory::Request(sizeof(std::thread) * threads);
+    for(Int i = 0; i < threads; i++) { new(workers + i)std::thread(work, i); }
+    while(ready.load() < threads) { std::this_thread::yield(); }
+    // -- //
+    auto begin = std::chrono::steady_clock::now();
+    start.store(true);
+    for(Int i = 0; i < threads; i++) { workers[i].join(); workers[i].~thread(); }
+    auto end = std::chrono::steady_clock::now();
+    Memory::Free(workers);
+
+    // Release the map and whatever it retired.
+    map.Release();
+    Memory::Epoch::Flush();
+    // -- //
+    Double seconds = std::chrono::duration<Double>(end - begin).count();
+    return (Double(operations) * threads) / seconds / 1000000.0;
+}
+
+// --------------------------------------------------------------------------------------------
+// Time random lookups into a half full Map with the specified number of slots, looping Find() versus a single FindMany(), and print
+// a row of the report. Each way is run a few times and the fastest run is reported, in milliseconds.
+static R2D::Void MapBenchLookups(R2D::Int slots, R2D::Int lookups)
+{
+    using namespace R2D;
+
+    Map<uInt, uLong> map;
+    // Fill half of the map. Multiplying by an odd constant keeps the keys unique while scattering them.
+    map.Expand(slots);
+    // -- //
+    for(Int i = 0; i < slots / 2; i++) { map.Add(uInt(i) * 2654435761u, uLong(i)); }
+
+    Array<uInt> keys;
+    Array<uLong*> found;
+    // Pick the keys to look up at random among the ones in the map.
+    keys.Reserve(lookups);
+    found.Reserve(lookups);
+    found.Count = lookups;
+    // -- //
+    uInt state = 2463534242u;
+    for(Int i = 0; i < lookups; i++)
+    {
+        state ^= state << 13; state ^= state >> 17; state ^= state << 5;
+        // -- //
+        keys.Append(uInt(state % uInt(slots / 2)) * 2654435761u);
+    }
+
+    // Time both ways, keeping a checksum of the results so neither can be optimized away.
+    Double best[2] = { 1e30, 1e30 };
+    uLong checksum[2] = { 0, 0 };
+    for(Int run = 0; run < 5; run++)
+    {
+        auto begin = std::chrono::steady_clock::now();
+        for(Int i = 0; i < lookups; i++) { found[i] = map.Find(keys[i]); }
+        auto middle = std::chrono::steady_clock::now();
+        // -- //
+        checksum[0] = 0;
+        for(Int i = 0; i < lookups; i++) { checksum[0] += *found[i]; }
+
+        auto start = std::chrono::steady_clock::now();
+        map.FindMany(keys.Data, lookups, found.Data);
+        auto end = std::chrono::steady_clock::now();
+        // -- //
+        checksum[1] = 0;
+        for(Int i = 0; i < lookups; i++) { checksum[1] += *found[i]; }
+
+        Double times[2] = { std::chrono::duration<Double, std::milli>(middle - begin).count(), std::chrono::duration<Double, std::milli>(end - start).count() };
+        // -- //
+        for(Int i = 0; i < 2; i++) { best[i] = times[i] < best[i] ? times[i] : best[i]; }
+    }
+
+    printf("%10d %10.1f %12.2f %12.2f %8.2fx\n", slots, Double(slots) * (sizeof(uInt) + sizeof(uLong)) / (1 << 20), best[0], best[1], best[0] / best[1]);
+    // -- //
+    if(checksum[0] != checksum[1]) { printf("The lookups disagree!\n"); }
+
+    // -- //
+    map.Release();
+}
+
+// --------------------------------------------------------------------------------------------
+// Measures how ConcurrentMap's throughput scales from one thread to every hardware thread, then Map's batched lookups on tables from
+// 64K slots up to the specified size, which should be well beyond the last-level cache:
+//     MapBench [-threads <count>] [-keys <count>] [-operations <count per thread>] [-slots <power of two>] [-lookups <count>]
+// Each workload is run with 1, 2, 4, ... threads, and the speedup is relative to the single-threaded run.
+int main(int argc, char** argv)
+{
+    using namespace R2D;
+
+    // Helpers
+    Int threads = Int(std::thread::hardware_concurrency());
+    Int keys = 1 << 16;
+    Int operations = 1 << 21;
+    Int slots = 1 << 25;
+    Int lookups = 1 << 20;
+
+    // Read the options.
+    for(Int i = 1; i < argc; i++)
+    {
+        // -- //
+        if(!strcmp(argv[i], "-threads") && i + 1 < argc) { threads = atoi(argv[++i]); }
+        else if(!strcmp(argv[i], "-keys") && i + 1 < argc) { keys = atoi(argv[++i]); }
+        else if(!strcmp(argv[i], "-operations") && i + 1 < argc) { operations = atoi(argv[++i]); }
+        else if(!strcmp(argv[i], "-slots") && i + 1 < argc) { slots = atoi(argv[++i]); }
+        else if(!strcmp(argv[i], "-lookups") && i + 1 < argc) { lookups = atoi(argv[++i]); }
+        else { printf("Usage: MapBench [-threads <count>] [-keys <count>] [-operations <count per thread>] [-slots <power of two>] [-lookups <count>]\n"); return 1; }
+    }
+    // -- //
+    if(threads < 1 || keys < 2 || operations < 1 || lookups < 1) { printf("The thread, key, operation and lookup counts must be positive.\n"); return 1; }
+    if(slots < 64 || slots > (1 << 26) || POPCNT(slots) != 1) { printf("The slot count must be a power of two, from 64 up to 2^26.\n"); return 1; }
+
+    // Read-heavy is the common case of shared lookup tables, mixed stresses the insertion, deletion and growth paths.
+    const MapBenchWorkload workloads[] = { { "read-heavy (98/1/1)", 98, 1 }, { "mixed (50/25/25)", 50, 25 } };
+
+    printf("%d keys, %d operations per thread, up to %d threads.\n", keys, operations, threads);
+    for(const MapBenchWorkload& workload : workloads)
+    {
+        printf("\n%s\n%8s %12s %9s\n", workload.Name, "threads", "Mops/s", "speedup");
+        // -- //
+        Double single = 0.0;
+        for(Int count = 1; ; count = (count * 2 > threads && count != threads) ? threads : count * 2)
+        {
+            Double throughput = MapBenchRun(workload, count, keys, operations);
+            if(count == 1) { single = throughput; }
+            // -- //
+            printf("%8d %12.2f %8.2fx\n", count, throughput, throughput / single);
+            if(count >= threads) { break; }
+        }
+    }
+
+    // Compare the batched lookups with single ones, from tables that fit in the caches to ones that don't.
+    printf("\nMap lookups, %d into half full tables\n%10s %10s %12s %12s %9s\n", lookups, "slots", "MiB", "Find ms", "FindMany ms", "speedup");
+    // -- //
+    for(Int size = (slots < (1 << 16)) ? slots : (1 << 16); ; size = (size * 4 > slots) ? slots : size * 4)
+    {
+        MapBenchLookups(size, lookups);
+        // -- //
+        if(size >= slots) { break; }
+    }
+    // -- //
+    return 0;
+}
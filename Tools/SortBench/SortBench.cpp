@@ -0,0 +1,131 @@
+/*
+-------------------------------------------------------------------------------
+    Filename: Tools/SortBench/SortBench.cpp
+-------------------------------------------------------------------------------
+*/
+
+// Includes
+#include "..\..\Source\Common\Array.hpp"
+#include "..\..\Source\Common\Sort.hpp"
+// -- //
+#include <algorithm>
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// --------------------------------------------------------------------------------------------
+// Sort random keys of one width with every method, at sizes from 1k up to the maximum, and print the fastest run of each in
+// milliseconds along with its speedup over std::sort. Every result is checked against std::stable_sort's.
+template <typename Entry> static R2D::Void SortBenchRun(const char* name, R2D::Int maximum)
+{
+    using namespace R2D;
+
+    // Helpers
+    enum { Methods = 4 };
+    const char* names[Methods] = { "std::sort", "Introsort", "Radix", "Parallel" };
+    auto less = [](const Entry& a, const Entry& b) { return a.Key < b.Key; };
+
+    Array<Entry> source, expected, work;
+    Entry* scratch = (Entry*)Memory::Request(sizeof(Entry) * maximum);
+    // -- //
+    source.Reserve(maximum);
+    expected.Reserve(maximum);
+    work.Reserve(maximum);
+
+    printf("\n%s keys\n%10s", name, "count");
+    for(Int i = 0; i < Methods; i++) { printf(" %12s %8s", names[i], "speedup"); }
+    printf("\n");
+
+    for(Int count = 1000; count <= maximum; count *= 10)
+    {
+        // Fill the keys at random (xorshift), with the indices in order so stability can be checked.
+        uLong state = 88172645463325252ull;
+        source.Count = count;
+        // -- //
+        for(Int i = 0; i < count; i++)
+        {
+            state ^= state << 13; state ^= state >> 7; state ^= state << 17;
+            // -- //
+            source[i].Key = decltype(Entry::Key)(state);
+            source[i].Index = uInt(i);
+        }
+
+        // Sort a reference copy with std::stable_sort, which gives the same order as the radix sorts (they're both stable).
+        Memory::Copy(expected.Data, source.Data, sizeof(Entry) * count);
+        expected.Count = count;
+        std::stable_sort(expected.Data, expected.Data + count, less);
+
+        // Every method gets the same unsorted copy. Small arrays are sorted many more times so their timings aren't just noise.
+        Int runs = 5 + (1 << 20) / count;
+        Double best[Methods] = { 1e30, 1e30, 1e30, 1e30 };
+        Bool valid[Methods] = { true, true, true, true };
+        // -- //
+        for(Int method = 0; method < Methods; method++)
+        {
+            for(Int run = 0; run < runs; run++)
+            {
+                Memory::Copy(work.Data, source.Data, sizeof(Entry) * count);
+                work.Count = count;
+
+                auto begin = std::chrono::steady_clock::now();
+                // -- //
+                if(method == 0) { std::sort(work.Data, work.Data + count, less); }
+                else if(method == 1) { Sort::Introsort(work.Data, count, less); }
+                else if(method == 2) { Sort::Radix(work.Data, count, scratch); }
+                else { Sort::Parallel(work.Data, count, scratch); }
+                // -- //
+                auto end = std::chrono::steady_clock::now();
+
+                Double time = std::chrono::duration<Double, std::milli>(end - begin).count();
+                best[method] = (time < best[method]) ? time : best[method];
+            }
+
+            // The radix sorts have to match the reference exactly; std::sort and Introsort aren't stable, so only their keys are compared.
+            for(Int i = 0; valid[method] && i < count; i++)
+            {
+                valid[method] = (work[i].Key == expected[i].Key) && (method < 2 || work[i].Index == expected[i].Index);
+            }
+        }
+
+        printf("%10d", count);
+        for(Int i = 0; i < Methods; i++) { printf(" %12.3f %7.2fx", best[i], best[0] / best[i]); }
+        printf("\n");
+        // -- //
+        for(Int i = 0; i < Methods; i++) { if(!valid[i]) { printf("%s sorted %d keys incorrectly!\n", names[i], count); } }
+    }
+
+    // -- //
+    Memory::Free(scratch);
+    source.Release();
+    expected.Release();
+    work.Release();
+}
+
+// --------------------------------------------------------------------------------------------
+// Compares Sort's radix sorts and Introsort with the standard library on random keys from 1k up to a maximum (1M by default):
+//     SortBench [-maximum <count>]
+// Both key widths are timed, since the 64-bit keys take twice as many radix passes.
+int main(int argc, char** argv)
+{
+    using namespace R2D;
+
+    // Helper
+    Int maximum = 1000000;
+
+    // Read the options.
+    for(Int i = 1; i < argc; i++)
+    {
+        // -- //
+        if(!strcmp(argv[i], "-maximum") && i + 1 < argc) { maximum = atoi(argv[++i]); }
+        else { printf("Usage: SortBench [-maximum <count>]\n"); return 1; }
+    }
+    // -- //
+    if(maximum < 1000) { printf("The maximum count must be at least 1000.\n"); return 1; }
+
+    printf("Fastest of several runs in milliseconds, speedups relative to std::sort.\n");
+    SortBenchRun<Sort::Key32>("32-bit", maximum);
+    SortBenchRun<Sort::Key64>("64-bit", maximum);
+    // -- //
+    return 0;
+}